@@ -44,6 +44,9 @@ public class Designer : ModuleRules
 				"LevelEditor",
 				"EditorStyle",
 				"Projects",
+				"AssetRegistry",
+				"ContentBrowser",
+				"Landscape",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
@@ -0,0 +1,289 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "DesignerPalette.h"
+#include "DesignerModule.h"
+
+#include "AssetRegistry/AssetData.h"
+#include "AssetSelection.h"
+#include "Editor.h"
+#include "Editor/EditorEngine.h"
+#include "Editor/UnrealEd/Classes/ActorFactories/ActorFactory.h"
+#include "Tools/AssetBoundsUtils.h"
+#include "Tools/PlaceableAssetIndex.h"
+
+FDesignerSettingsOverride::FDesignerSettingsOverride()
+	: bOverrideAxisToAlignWithNormal(false)
+	, AxisToAlignWithNormal(EAxisType::Up)
+	, bOverrideAxisToAlignWithCursor(false)
+	, AxisToAlignWithCursor(EAxisType::Forward)
+	, bOverrideRelativeLocationOffset(false)
+	, RelativeLocationOffset(FVector::ZeroVector)
+	, bOverrideWorldLocationOffset(false)
+	, WorldLocationOffset(FVector::ZeroVector)
+	, bOverrideRandomRotation(false)
+	, RandomRotation(FRandomMinMaxFloat(0.F, 360.F), FRandomMinMaxFloat(0.F, 360.F), FRandomMinMaxFloat(0.F, 360.F))
+	, bOverrideMinimalScale(false)
+	, MinimalScale(0.3F)
+	, bOverrideRandomScale(false)
+	, RandomScale(FRandomMinMaxFloat(0.8F, 1.2F, true), FRandomMinMaxFloat(0.8F, 1.2F, true), FRandomMinMaxFloat(0.8F, 1.2F, true))
+{
+}
+
+bool FDesignerSettingsOverride::HasOverrides() const
+{
+	return bOverrideAxisToAlignWithNormal
+		|| bOverrideAxisToAlignWithCursor
+		|| bOverrideRelativeLocationOffset
+		|| bOverrideWorldLocationOffset
+		|| bOverrideRandomRotation
+		|| bOverrideMinimalScale
+		|| bOverrideRandomScale;
+}
+
+void FDesignerSettingsOverride::ApplyTo(UDesignerSettings* DesignerSettings) const
+{
+	if (DesignerSettings == nullptr)
+		return;
+
+	if (bOverrideAxisToAlignWithNormal)
+		DesignerSettings->AxisToAlignWithNormal = AxisToAlignWithNormal;
+
+	if (bOverrideAxisToAlignWithCursor)
+		DesignerSettings->AxisToAlignWithCursor = AxisToAlignWithCursor;
+
+	if (bOverrideRelativeLocationOffset)
+		DesignerSettings->RelativeLocationOffset = RelativeLocationOffset;
+
+	if (bOverrideWorldLocationOffset)
+		DesignerSettings->WorldLocationOffset = WorldLocationOffset;
+
+	if (bOverrideRandomRotation)
+	{
+		DesignerSettings->bApplyRandomRotation = true;
+		DesignerSettings->RandomRotation = RandomRotation;
+	}
+
+	if (bOverrideMinimalScale)
+		DesignerSettings->MinimalScale = MinimalScale;
+
+	if (bOverrideRandomScale)
+	{
+		DesignerSettings->bApplyRandomScale = true;
+		DesignerSettings->RandomScale = RandomScale;
+	}
+}
+
+FDesignerPaletteEntry::FDesignerPaletteEntry()
+	: Weight(1.F)
+	, bPlaceable(false)
+	, LocalExtent(FVector(50.F))
+	, ActorFactoryClass(nullptr)
+{
+}
+
+UDesignerPalette::UDesignerPalette(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+}
+
+int32 UDesignerPalette::PickRandomEntryIndex() const
+{
+	const int32 EntryCount = AliasProbabilities.Num();
+	if (EntryCount == 0 || EntryCount != Entries.Num() || AliasIndices.Num() != EntryCount)
+		return INDEX_NONE;
+
+	const int32 EntryIndex = FMath::RandRange(0, EntryCount - 1);
+	return FMath::FRand() < AliasProbabilities[EntryIndex] ? EntryIndex : AliasIndices[EntryIndex];
+}
+
+UActorFactory* UDesignerPalette::GetActorFactory(int32 EntryIndex)
+{
+	if (!Entries.IsValidIndex(EntryIndex) || GEditor == nullptr)
+		return nullptr;
+
+	if (ResolvedActorFactories.Num() != Entries.Num())
+	{
+		ResolvedActorFactories.Init(nullptr, Entries.Num());
+	}
+
+	UActorFactory*& ActorFactory = ResolvedActorFactories[EntryIndex];
+	if (ActorFactory == nullptr && Entries[EntryIndex].ActorFactoryClass != nullptr)
+	{
+		ActorFactory = GEditor->FindActorFactoryByClass(Entries[EntryIndex].ActorFactoryClass);
+	}
+
+	return ActorFactory;
+}
+
+void UDesignerPalette::Bake()
+{
+	// Only used for the asset registry based placeability rules, so there is no need to listen to registry events.
+	FPlaceableAssetIndex PlaceableAssetIndex;
+
+	for (FDesignerPaletteEntry& Entry : Entries)
+	{
+		BakeEntry(Entry, PlaceableAssetIndex);
+	}
+
+	ResolvedActorFactories.Empty();
+
+	BuildAliasTable();
+}
+
+void UDesignerPalette::BakeEntry(FDesignerPaletteEntry& Entry, FPlaceableAssetIndex& PlaceableAssetIndex)
+{
+	Entry.bPlaceable = false;
+	Entry.ActorFactoryClass = nullptr;
+
+	UObject* Asset = Entry.Asset.LoadSynchronous();
+	if (Asset == nullptr)
+		return;
+
+	const FAssetData AssetData(Asset);
+	UActorFactory* ActorFactory = PlaceableAssetIndex.FindActorFactory(AssetData);
+
+	Entry.bPlaceable = ActorFactory != nullptr;
+	Entry.ActorFactoryClass = ActorFactory != nullptr ? ActorFactory->GetClass() : nullptr;
+	Entry.LocalExtent = FAssetBoundsUtils::CalculateLocalExtent(Asset);
+}
+
+void UDesignerPalette::PreSave(FObjectPreSaveContext ObjectSaveContext)
+{
+	Super::PreSave(ObjectSaveContext);
+
+	if (!ObjectSaveContext.IsProceduralSave())
+	{
+		Bake();
+	}
+}
+
+void UDesignerPalette::PostLoad()
+{
+	Super::PostLoad();
+
+	// Palettes saved before the alias table existed still have to be sampled.
+	if (AliasProbabilities.Num() != Entries.Num())
+	{
+		BuildAliasTable();
+	}
+}
+
+#if WITH_EDITOR
+void UDesignerPalette::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// Changing a weight doesn't require loading the assets again.
+	if (PropertyChangedEvent.GetPropertyName() == GET_MEMBER_NAME_CHECKED(FDesignerPaletteEntry, Weight))
+	{
+		BuildAliasTable();
+		return;
+	}
+
+	// Only the asset of the changed entry is loaded, every entry is baked again when the palette is saved.
+	if (PropertyChangedEvent.GetPropertyName() == GET_MEMBER_NAME_CHECKED(FDesignerPaletteEntry, Asset))
+	{
+		const int32 EntryIndex = PropertyChangedEvent.GetArrayIndex(GET_MEMBER_NAME_STRING_CHECKED(UDesignerPalette, Entries));
+		if (Entries.IsValidIndex(EntryIndex))
+		{
+			FPlaceableAssetIndex PlaceableAssetIndex;
+			BakeEntry(Entries[EntryIndex], PlaceableAssetIndex);
+		}
+	}
+
+	// Entries might have been added, removed or moved, which invalidates the resolved factories and the alias table.
+	ResolvedActorFactories.Empty();
+	BuildAliasTable();
+}
+#endif
+
+void UDesignerPalette::BuildAliasTable()
+{
+	const int32 EntryCount = Entries.Num();
+
+	AliasProbabilities.Init(0.F, EntryCount);
+	AliasIndices.Init(INDEX_NONE, EntryCount);
+
+	double TotalWeight = 0.0;
+	for (const FDesignerPaletteEntry& Entry : Entries)
+	{
+		TotalWeight += Entry.bPlaceable ? FMath::Max(Entry.Weight, 0.F) : 0.F;
+	}
+
+	if (TotalWeight <= 0.0)
+	{
+		AliasProbabilities.Empty();
+		AliasIndices.Empty();
+		return;
+	}
+
+	// Scale the weights so the average is one, then pair every entry below one with an entry above one.
+	TArray<double> ScaledWeights;
+	ScaledWeights.SetNumUninitialized(EntryCount);
+
+	TArray<int32> SmallIndices;
+	TArray<int32> LargeIndices;
+
+	for (int32 EntryIndex = 0; EntryIndex < EntryCount; EntryIndex++)
+	{
+		const FDesignerPaletteEntry& Entry = Entries[EntryIndex];
+		const double Weight = Entry.bPlaceable ? FMath::Max(Entry.Weight, 0.F) : 0.0;
+		ScaledWeights[EntryIndex] = Weight * EntryCount / TotalWeight;
+
+		if (ScaledWeights[EntryIndex] < 1.0)
+			SmallIndices.Add(EntryIndex);
+		else
+			LargeIndices.Add(EntryIndex);
+	}
+
+	while (SmallIndices.Num() > 0 && LargeIndices.Num() > 0)
+	{
+		const int32 SmallIndex = SmallIndices.Pop(false);
+		const int32 LargeIndex = LargeIndices.Pop(false);
+
+		AliasProbabilities[SmallIndex] = (float)ScaledWeights[SmallIndex];
+		AliasIndices[SmallIndex] = LargeIndex;
+
+		ScaledWeights[LargeIndex] = (ScaledWeights[LargeIndex] + ScaledWeights[SmallIndex]) - 1.0;
+
+		if (ScaledWeights[LargeIndex] < 1.0)
+			SmallIndices.Add(LargeIndex);
+		else
+			LargeIndices.Add(LargeIndex);
+	}
+
+	// Whatever is left is one within floating point precision.
+	for (int32 EntryIndex : LargeIndices)
+	{
+		AliasProbabilities[EntryIndex] = 1.F;
+		AliasIndices[EntryIndex] = EntryIndex;
+	}
+
+	for (int32 EntryIndex : SmallIndices)
+	{
+		AliasProbabilities[EntryIndex] = 1.F;
+		AliasIndices[EntryIndex] = EntryIndex;
+	}
+}
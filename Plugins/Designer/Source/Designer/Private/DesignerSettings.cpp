@@ -25,10 +25,18 @@
 #include "DesignerSettings.h"
 #include "DesignerEdMode.h"
 
+#include "Components/SkinnedMeshComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+
 UDesignerSettings::UDesignerSettings(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 	, AxisToAlignWithNormal(EAxisType::Up)
 	, AxisToAlignWithCursor(EAxisType::Forward)
+	, bEstimateSurfaceNormal(false)
+	, SurfaceNormalSampleRadius(25.F)
+	, SurfaceNormalSampleCount(8)
 	, RelativeLocationOffset(FVector::ZeroVector)
 	, bScaleRelativeLocationOffset(false)
 	, WorldLocationOffset(FVector::ZeroVector)
@@ -42,7 +50,73 @@ UDesignerSettings::UDesignerSettings(const FObjectInitializer& ObjectInitializer
 	, bApplyRandomScale(false)
 	, bUseUniformRandomScale(true)
 	, RandomScale(FRandomMinMaxFloat(0.8F, 1.2F, true), FRandomMinMaxFloat(0.8F, 1.2F, true), FRandomMinMaxFloat(0.8F, 1.2F, true))
+	, Palette(nullptr)
+	, ResidencyCacheMaxAssets(32)
+	, ResidencyCacheBudgetMB(512)
+	, bPrefetchAssetExtents(false)
+	, PreviewPoolMaxActors(16)
+	, PreviewPoolMaxActorsPerAsset(2)
+	, bUseMeshPreviewComponent(true)
+	, bUseBlueprintTemplatePreview(true)
+	, PlacementTraceCacheTolerance(1.F)
+	, bUseDesignerPlacementTrace(true)
+	, PlacementTraceChannel(ECC_Visibility)
+	, bBuildStaticGeometryBVH(false)
+	, StaticGeometryRegion(ForceInit)
+	, bUseLandscapeHeightfieldPlacement(false)
+	, bDeferControlledActorUpdates(true)
+	, bUseAsyncHoverTraces(false)
+{
+	PreviewCollisionProfile.Name = UCollisionProfile::NoCollision_ProfileName;
+}
+
+void FPreviewRenderPolicy::ApplyTo(UPrimitiveComponent* PrimitiveComponent) const
+{
+	if (PrimitiveComponent == nullptr)
+		return;
+
+	// The flags are set directly, so the render state is only recreated once for all of them.
+	PrimitiveComponent->CastShadow = bCastShadows;
+	PrimitiveComponent->bAffectDistanceFieldLighting = bAffectDistanceFieldLighting;
+	PrimitiveComponent->bAffectDynamicIndirectLighting = bAffectDynamicIndirectLighting;
+	PrimitiveComponent->bVisibleInRayTracing = bVisibleInRayTracing;
+
+	if (UStaticMeshComponent* StaticMeshComponent = Cast<UStaticMeshComponent>(PrimitiveComponent))
+	{
+		StaticMeshComponent->ForcedLodModel = GetStaticMeshForcedLodModel(StaticMeshComponent->GetStaticMesh());
+
+		// Nanite ignores the forced LOD, the fallback mesh is rendered instead when the LOD or triangle count is limited.
+		StaticMeshComponent->bDisallowNanite = ForcedLOD > 0 || MaxTriangles > 0;
+	}
+	else if (USkinnedMeshComponent* SkinnedMeshComponent = Cast<USkinnedMeshComponent>(PrimitiveComponent))
+	{
+		SkinnedMeshComponent->SetForcedLOD(ForcedLOD);
+	}
+
+	PrimitiveComponent->MarkRenderStateDirty();
+}
+
+int32 FPreviewRenderPolicy::GetStaticMeshForcedLodModel(const UStaticMesh* StaticMesh) const
 {
+	if (StaticMesh == nullptr || StaticMesh->GetRenderData() == nullptr)
+		return ForcedLOD;
+
+	const int32 NumLODs = StaticMesh->GetNumLODs();
+	int32 LODIndex = ForcedLOD > 0 ? FMath::Min(ForcedLOD - 1, NumLODs - 1) : 0;
+
+	if (MaxTriangles > 0)
+	{
+		while (LODIndex < NumLODs - 1 && StaticMesh->GetNumTriangles(LODIndex) > MaxTriangles)
+		{
+			LODIndex++;
+		}
+	}
+	else if (ForcedLOD == 0)
+	{
+		return 0;
+	}
+
+	return LODIndex + 1;
 }
 
 FVector UDesignerSettings::GetScale()
@@ -63,3 +137,14 @@ FVector UDesignerSettings::GetScale()
 		return FVector(MinimalScale);
 	}
 }
+
+void UDesignerSettings::CopySettingsFrom(const UDesignerSettings* Other)
+{
+	if (Other == nullptr || Other == this)
+		return;
+
+	for (TFieldIterator<FProperty> PropertyIterator(UDesignerSettings::StaticClass()); PropertyIterator; ++PropertyIterator)
+	{
+		PropertyIterator->CopyCompleteValue_InContainer(this, Other);
+	}
+}
@@ -0,0 +1,238 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "AssetBoundsUtils.h"
+
+#include "Components/PrimitiveComponent.h"
+#include "Engine/Blueprint.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "Engine/SCS_Node.h"
+#include "Engine/SimpleConstructionScript.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/StaticMesh.h"
+#include "GameFramework/Actor.h"
+
+namespace
+{
+	/** The transform of a component relative to the actor, without the transform of the root component which is the actor transform. */
+	FTransform GetComponentToActorTransform(const USceneComponent* SceneComponent)
+	{
+		FTransform ComponentToActor = FTransform::Identity;
+		for (const USceneComponent* Component = SceneComponent; Component != nullptr && Component->GetAttachParent() != nullptr; Component = Component->GetAttachParent())
+		{
+			ComponentToActor = ComponentToActor * Component->GetRelativeTransform();
+		}
+
+		return ComponentToActor;
+	}
+
+	/** The transform of the component a root node of a construction script is attached to, relative to the actor */
+	FTransform GetParentToActorTransform(const USCS_Node* RootNode, const AActor* DefaultActor, const TMap<FName, FTransform>& NodeTransforms)
+	{
+		// Without a parent the node is attached to the root component, which is the actor transform.
+		if (RootNode->ParentComponentOrVariableName == NAME_None)
+			return FTransform::Identity;
+
+		FTransform ParentToActor = FTransform::Identity;
+		if (RootNode->bIsParentComponentNative)
+		{
+			if (DefaultActor != nullptr)
+			{
+				DefaultActor->ForEachComponent<USceneComponent>(false, [RootNode, &ParentToActor](const USceneComponent* SceneComponent)
+				{
+					if (SceneComponent->GetFName() == RootNode->ParentComponentOrVariableName)
+					{
+						ParentToActor = GetComponentToActorTransform(SceneComponent);
+					}
+				});
+			}
+		}
+		else if (const FTransform* NodeTransform = NodeTransforms.Find(RootNode->ParentComponentOrVariableName))
+		{
+			// The parent is a node in the construction script of a parent class, which was added before.
+			ParentToActor = *NodeTransform;
+		}
+
+		return ParentToActor;
+	}
+
+	void AddComponentTemplates(const USCS_Node* Node, UBlueprintGeneratedClass* ActualClass, const FTransform& ParentToActor, bool bIsRootNode, TMap<FName, FTransform>& NodeTransforms, TArray<FPrimitiveComponentTemplate>& OutTemplates)
+	{
+		if (Node == nullptr)
+			return;
+
+		FTransform ComponentToActor = ParentToActor;
+
+		// Child blueprints override the templates inherited from their parents through their inheritable component handler.
+		if (const USceneComponent* SceneComponent = Cast<USceneComponent>(Node->GetActualComponentTemplate(ActualClass)))
+		{
+			// The root component transform is the actor transform.
+			if (!bIsRootNode)
+			{
+				ComponentToActor = SceneComponent->GetRelativeTransform() * ParentToActor;
+			}
+
+			const UPrimitiveComponent* PrimitiveComponent = Cast<UPrimitiveComponent>(SceneComponent);
+			if (PrimitiveComponent != nullptr && !PrimitiveComponent->bHiddenInGame)
+			{
+				OutTemplates.Add({ PrimitiveComponent, ComponentToActor });
+			}
+		}
+
+		NodeTransforms.Add(Node->GetVariableName(), ComponentToActor);
+
+		for (const USCS_Node* ChildNode : Node->GetChildNodes())
+		{
+			AddComponentTemplates(ChildNode, ActualClass, ComponentToActor, false, NodeTransforms, OutTemplates);
+		}
+	}
+}
+
+FBox FAssetBoundsUtils::CalculateLocalBounds(const UObject* Asset)
+{
+	if (const UStaticMesh* StaticMesh = Cast<UStaticMesh>(Asset))
+	{
+		return StaticMesh->GetBoundingBox();
+	}
+
+	if (const USkeletalMesh* SkeletalMesh = Cast<USkeletalMesh>(Asset))
+	{
+		return SkeletalMesh->GetBounds().GetBox();
+	}
+
+	const UClass* ActorClass = nullptr;
+	if (const UBlueprint* Blueprint = Cast<UBlueprint>(Asset))
+	{
+		ActorClass = Blueprint->GeneratedClass;
+	}
+	else
+	{
+		ActorClass = Cast<UClass>(Asset);
+	}
+
+	if (ActorClass == nullptr || !ActorClass->IsChildOf(AActor::StaticClass()))
+	{
+		return FBox(ForceInit);
+	}
+
+	TArray<FPrimitiveComponentTemplate> Templates;
+	GatherPrimitiveComponentTemplates(ActorClass, Templates);
+
+	FBox Bounds(ForceInit);
+	for (const FPrimitiveComponentTemplate& Template : Templates)
+	{
+		const FBoxSphereBounds ComponentBounds = Template.Template->CalcBounds(Template.ComponentToActor);
+		if (ComponentBounds.BoxExtent.SizeSquared() > 0.F)
+		{
+			Bounds += ComponentBounds.GetBox();
+		}
+	}
+
+	return Bounds;
+}
+
+FVector FAssetBoundsUtils::CalculateLocalExtent(const UObject* Asset, const FVector& FallbackExtent)
+{
+	const FBox Bounds = CalculateLocalBounds(Asset);
+	return Bounds.IsValid ? Bounds.GetExtent() : FallbackExtent;
+}
+
+bool FAssetBoundsUtils::HasExactBounds(const UObject* Asset)
+{
+	return Asset != nullptr && (Asset->IsA<UStaticMesh>() || Asset->IsA<USkeletalMesh>());
+}
+
+void FAssetBoundsUtils::GatherPrimitiveComponentTemplates(const UClass* ActorClass, TArray<FPrimitiveComponentTemplate>& OutTemplates)
+{
+	if (ActorClass == nullptr || !ActorClass->IsChildOf(AActor::StaticClass()))
+		return;
+
+	GatherNativeComponents(ActorClass->GetDefaultObject<AActor>(), OutTemplates);
+	GatherComponentTemplates(Cast<UBlueprintGeneratedClass>(ActorClass), OutTemplates);
+}
+
+void FAssetBoundsUtils::GatherNativeComponents(const AActor* DefaultActor, TArray<FPrimitiveComponentTemplate>& OutTemplates)
+{
+	if (DefaultActor == nullptr)
+		return;
+
+	DefaultActor->ForEachComponent<UPrimitiveComponent>(false, [&OutTemplates](const UPrimitiveComponent* PrimitiveComponent)
+	{
+		if (!PrimitiveComponent->bHiddenInGame)
+		{
+			OutTemplates.Add({ PrimitiveComponent, GetComponentToActorTransform(PrimitiveComponent) });
+		}
+	});
+}
+
+void FAssetBoundsUtils::GatherComponentTemplates(const UBlueprintGeneratedClass* BlueprintGeneratedClass, TArray<FPrimitiveComponentTemplate>& OutTemplates)
+{
+	if (BlueprintGeneratedClass == nullptr)
+		return;
+
+	const AActor* DefaultActor = BlueprintGeneratedClass->GetDefaultObject<AActor>();
+
+	// The overrides of the inherited templates are looked up from the class itself, so it can't be const.
+	UBlueprintGeneratedClass* ActualClass = const_cast<UBlueprintGeneratedClass*>(BlueprintGeneratedClass);
+
+	// Components added in parent blueprints live in the construction scripts of the parent classes, which are added first so child nodes can be attached to them.
+	TArray<const UBlueprintGeneratedClass*, TInlineAllocator<4>> Classes;
+	for (const UBlueprintGeneratedClass* Class = BlueprintGeneratedClass; Class != nullptr; Class = Cast<UBlueprintGeneratedClass>(Class->GetSuperClass()))
+	{
+		if (Class->SimpleConstructionScript != nullptr)
+		{
+			Classes.Insert(Class, 0);
+		}
+	}
+
+	// Without a native root component the first scene component of the most-base construction script becomes the root component, which is the actor transform.
+	// The other root nodes are attached to it.
+	const USCS_Node* ActorRootNode = nullptr;
+	if (DefaultActor != nullptr && DefaultActor->GetRootComponent() == nullptr)
+	{
+		for (int32 ClassIndex = 0; ClassIndex < Classes.Num() && ActorRootNode == nullptr; ClassIndex++)
+		{
+			for (const USCS_Node* RootNode : Classes[ClassIndex]->SimpleConstructionScript->GetRootNodes())
+			{
+				if (RootNode != nullptr && Cast<USceneComponent>(RootNode->GetActualComponentTemplate(ActualClass)) != nullptr)
+				{
+					ActorRootNode = RootNode;
+					break;
+				}
+			}
+		}
+	}
+
+	TMap<FName, FTransform> NodeTransforms;
+	for (const UBlueprintGeneratedClass* Class : Classes)
+	{
+		for (const USCS_Node* RootNode : Class->SimpleConstructionScript->GetRootNodes())
+		{
+			if (RootNode != nullptr)
+			{
+				AddComponentTemplates(RootNode, ActualClass, GetParentToActorTransform(RootNode, DefaultActor, NodeTransforms), RootNode == ActorRootNode, NodeTransforms, OutTemplates);
+			}
+		}
+	}
+}
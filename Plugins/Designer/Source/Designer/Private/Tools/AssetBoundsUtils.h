@@ -0,0 +1,71 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+class UBlueprintGeneratedClass;
+class UPrimitiveComponent;
+
+/** A primitive component of an actor class, either native or from a construction script, and its transform relative to the actor */
+struct FPrimitiveComponentTemplate
+{
+	const UPrimitiveComponent* Template;
+
+	FTransform ComponentToActor;
+};
+
+/**
+ * Calculates the local bounds of placeable assets without spawning an actor for them.
+ */
+class FAssetBoundsUtils
+{
+public:
+	/**
+	 * Calculate the local space bounds of the actor which would be spawned for the asset.
+	 * Static meshes, skeletal meshes and blueprints are supported. Returns an invalid box for anything else.
+	 */
+	static FBox CalculateLocalBounds(const UObject* Asset);
+
+	/** The local extent of the asset, or the fallback extent when the bounds can't be calculated */
+	static FVector CalculateLocalExtent(const UObject* Asset, const FVector& FallbackExtent = FVector(50.F));
+
+	/**
+	 * True if the calculated bounds are the bounds of the spawned actor, like for meshes.
+	 * The bounds of actor classes are calculated from their component templates, which misses anything added by the construction script.
+	 */
+	static bool HasExactBounds(const UObject* Asset);
+
+	/** Gather the visible primitive components of an actor class without running its construction script */
+	static void GatherPrimitiveComponentTemplates(const UClass* ActorClass, TArray<FPrimitiveComponentTemplate>& OutTemplates);
+
+private:
+	/** Gather the native primitive components of the class default object */
+	static void GatherNativeComponents(const AActor* DefaultActor, TArray<FPrimitiveComponentTemplate>& OutTemplates);
+
+	/** Gather the primitive component templates of the simple construction scripts of the class and its parent classes, with the overrides of the class applied */
+	static void GatherComponentTemplates(const UBlueprintGeneratedClass* BlueprintGeneratedClass, TArray<FPrimitiveComponentTemplate>& OutTemplates);
+};
@@ -0,0 +1,261 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "AssetExtentCache.h"
+#include "AssetBoundsUtils.h"
+#include "DesignerModule.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Serialization/Archive.h"
+
+namespace
+{
+	/** Increase when the file layout or the way extents are calculated changes, older files are ignored */
+	const int32 ExtentCacheFileVersion = 1;
+
+	const uint32 ExtentCacheFileMagic = 0x44455843; // DEXC
+}
+
+FAssetExtentCache::FAssetExtentCache()
+	: bIsLoaded(false)
+	, bIsDirty(false)
+{
+
+}
+
+FAssetExtentCache::~FAssetExtentCache()
+{
+	CancelPrefetch();
+}
+
+void FAssetExtentCache::Load()
+{
+	if (bIsLoaded)
+		return;
+
+	bIsLoaded = true;
+
+	TUniquePtr<FArchive> FileReader(IFileManager::Get().CreateFileReader(*GetCacheFilePath()));
+	if (!FileReader.IsValid())
+		return;
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	*FileReader << Magic;
+	*FileReader << Version;
+
+	if (Magic != ExtentCacheFileMagic || Version != ExtentCacheFileVersion)
+	{
+		UE_LOG(LogDesigner, Log, TEXT("Ignoring extent cache %s with an unsupported version."), *GetCacheFilePath());
+		return;
+	}
+
+	int32 EntryCount = 0;
+	*FileReader << EntryCount;
+	Entries.Reserve(EntryCount);
+
+	for (int32 EntryIndex = 0; EntryIndex < EntryCount && !FileReader->IsError(); EntryIndex++)
+	{
+		FString ObjectPath;
+		FExtentEntry Entry;
+		*FileReader << ObjectPath;
+		*FileReader << Entry.PackageSavedHash;
+		*FileReader << Entry.Extent;
+
+		Entries.Add(FName(*ObjectPath), Entry);
+	}
+
+	if (FileReader->IsError())
+	{
+		UE_LOG(LogDesigner, Warning, TEXT("Extent cache %s is corrupt and is discarded."), *GetCacheFilePath());
+		Entries.Empty();
+	}
+	else
+	{
+		UE_LOG(LogDesigner, Log, TEXT("Loaded %d asset extents from %s."), Entries.Num(), *GetCacheFilePath());
+	}
+}
+
+void FAssetExtentCache::Save()
+{
+	if (!bIsDirty)
+		return;
+
+	TUniquePtr<FArchive> FileWriter(IFileManager::Get().CreateFileWriter(*GetCacheFilePath()));
+	if (!FileWriter.IsValid())
+	{
+		UE_LOG(LogDesigner, Warning, TEXT("Failed to write extent cache %s."), *GetCacheFilePath());
+		return;
+	}
+
+	int32 EntryCount = 0;
+	for (const TPair<FName, FExtentEntry>& Pair : Entries)
+	{
+		EntryCount += Pair.Value.bIsPersistent ? 1 : 0;
+	}
+
+	uint32 Magic = ExtentCacheFileMagic;
+	int32 Version = ExtentCacheFileVersion;
+	*FileWriter << Magic;
+	*FileWriter << Version;
+	*FileWriter << EntryCount;
+
+	for (TPair<FName, FExtentEntry>& Pair : Entries)
+	{
+		if (!Pair.Value.bIsPersistent)
+			continue;
+
+		FString ObjectPath = Pair.Key.ToString();
+		*FileWriter << ObjectPath;
+		*FileWriter << Pair.Value.PackageSavedHash;
+		*FileWriter << Pair.Value.Extent;
+	}
+
+	bIsDirty = false;
+}
+
+bool FAssetExtentCache::Find(const FAssetData& AssetData, FVector& OutExtent) const
+{
+	const FExtentEntry* Entry = Entries.Find(AssetData.ObjectPath);
+	if (Entry == nullptr)
+		return false;
+
+	// The package was saved again, so the extent might be outdated.
+	FIoHash PackageSavedHash;
+	if (!GetPackageSavedHash(AssetData, PackageSavedHash) || PackageSavedHash != Entry->PackageSavedHash)
+		return false;
+
+	OutExtent = Entry->Extent;
+	return true;
+}
+
+void FAssetExtentCache::Add(const FAssetData& AssetData, const FVector& Extent, bool bIsPersistent)
+{
+	// Assets which are not saved yet have no hash to validate against.
+	FIoHash PackageSavedHash;
+	if (!GetPackageSavedHash(AssetData, PackageSavedHash))
+		return;
+
+	FExtentEntry* Entry = Entries.Find(AssetData.ObjectPath);
+	if (Entry == nullptr)
+	{
+		Entry = &Entries.Add(AssetData.ObjectPath);
+	}
+	else if (!bIsPersistent && Entry->bIsPersistent && Entry->PackageSavedHash == PackageSavedHash)
+	{
+		// The persistent extent was measured on a spawned actor, an estimate is never better.
+		return;
+	}
+
+	if (Entry->PackageSavedHash != PackageSavedHash || !Entry->Extent.Equals(Extent) || Entry->bIsPersistent != bIsPersistent)
+	{
+		Entry->PackageSavedHash = PackageSavedHash;
+		Entry->Extent = Extent;
+		Entry->bIsPersistent = bIsPersistent;
+		bIsDirty |= bIsPersistent;
+	}
+}
+
+void FAssetExtentCache::Prefetch(const TArray<FAssetData>& Assets, int32 MaxAssets)
+{
+	PrefetchQueue.Reset();
+
+	FVector UnusedExtent;
+	for (const FAssetData& AssetData : Assets)
+	{
+		if (PrefetchQueue.Num() >= MaxAssets)
+			break;
+
+		if (!Find(AssetData, UnusedExtent))
+		{
+			PrefetchQueue.Add(AssetData);
+		}
+	}
+
+	if (!PrefetchHandle.IsValid())
+	{
+		PrefetchNext();
+	}
+}
+
+void FAssetExtentCache::CancelPrefetch()
+{
+	PrefetchQueue.Empty();
+
+	if (PrefetchHandle.IsValid())
+	{
+		PrefetchHandle->CancelHandle();
+		PrefetchHandle.Reset();
+	}
+}
+
+void FAssetExtentCache::PrefetchNext()
+{
+	PrefetchHandle.Reset();
+
+	while (PrefetchQueue.Num() > 0)
+	{
+		PrefetchAssetData = PrefetchQueue.Pop(false);
+
+		// Assets which are already loaded don't have to be streamed in.
+		if (UObject* Asset = PrefetchAssetData.FastGetAsset(false))
+		{
+			Add(PrefetchAssetData, FAssetBoundsUtils::CalculateLocalExtent(Asset), FAssetBoundsUtils::HasExactBounds(Asset));
+			continue;
+		}
+
+		PrefetchHandle = StreamableManager.RequestAsyncLoad(PrefetchAssetData.ToSoftObjectPath(), FStreamableDelegate::CreateRaw(this, &FAssetExtentCache::OnPrefetchAssetLoaded));
+		return;
+	}
+}
+
+void FAssetExtentCache::OnPrefetchAssetLoaded()
+{
+	if (UObject* Asset = PrefetchAssetData.FastGetAsset(false))
+	{
+		Add(PrefetchAssetData, FAssetBoundsUtils::CalculateLocalExtent(Asset), FAssetBoundsUtils::HasExactBounds(Asset));
+	}
+
+	// Releasing the handle allows the garbage collector to unload the asset again.
+	PrefetchNext();
+}
+
+bool FAssetExtentCache::GetPackageSavedHash(const FAssetData& AssetData, FIoHash& OutPackageSavedHash)
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	TOptional<FAssetPackageData> PackageData = AssetRegistry.GetAssetPackageDataCopy(AssetData.PackageName);
+	if (!PackageData.IsSet() || PackageData->PackageSavedHash.IsZero())
+		return false;
+
+	OutPackageSavedHash = PackageData->PackageSavedHash;
+	return true;
+}
+
+FString FAssetExtentCache::GetCacheFilePath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("Designer") / TEXT("AssetExtentCache.bin");
+}
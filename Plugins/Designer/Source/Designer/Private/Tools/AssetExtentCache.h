@@ -0,0 +1,108 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "Engine/StreamableManager.h"
+#include "IO/IoHash.h"
+
+/**
+ * Persistent cache of the local extent of assets, stored in the saved directory of the project.
+ * Entries are keyed by the asset path and the saved hash of the package, so re-saving a package invalidates its entry.
+ */
+class FAssetExtentCache
+{
+private:
+	struct FExtentEntry
+	{
+		/** The saved hash of the package when the extent was calculated */
+		FIoHash PackageSavedHash;
+
+		/** The local box extent of the asset in cm when scale is uniform 1 */
+		FVector Extent;
+
+		/** False if the extent is only an estimate which is not written to the cache file */
+		bool bIsPersistent = true;
+	};
+
+	/** The cached extents per asset object path */
+	TMap<FName, FExtentEntry> Entries;
+
+	/** True once the cache file has been read */
+	bool bIsLoaded;
+
+	/** True if entries were added since the cache file was written */
+	bool bIsDirty;
+
+	/** Streams in the assets which are prefetched */
+	FStreamableManager StreamableManager;
+
+	/** The assets waiting to have their extent calculated */
+	TArray<FAssetData> PrefetchQueue;
+
+	/** The asset currently streaming in to have its extent calculated */
+	FAssetData PrefetchAssetData;
+
+	TSharedPtr<FStreamableHandle> PrefetchHandle;
+
+public:
+	FAssetExtentCache();
+
+	~FAssetExtentCache();
+
+	/** Read the cache file, does nothing when it is already read */
+	void Load();
+
+	/** Write the cache file when entries have been added */
+	void Save();
+
+	/** Find the extent of the asset. Fails when the package has been saved since the extent was calculated. */
+	bool Find(const FAssetData& AssetData, FVector& OutExtent) const;
+
+	/**
+	 * Store the extent of the asset for the currently saved version of its package.
+	 * Extents which are not persistent are only kept until the editor is closed and never replace a persistent extent.
+	 */
+	void Add(const FAssetData& AssetData, const FVector& Extent, bool bIsPersistent = true);
+
+	/** Calculate the extent of up to MaxAssets assets which are not cached yet, one asset at a time without blocking the game thread */
+	void Prefetch(const TArray<FAssetData>& Assets, int32 MaxAssets);
+
+	/** Stop calculating the extent of queued assets */
+	void CancelPrefetch();
+
+	FORCEINLINE int32 Num() const { return Entries.Num(); }
+
+private:
+	/** Stream in the next asset of the prefetch queue */
+	void PrefetchNext();
+
+	void OnPrefetchAssetLoaded();
+
+	static bool GetPackageSavedHash(const FAssetData& AssetData, FIoHash& OutPackageSavedHash);
+
+	static FString GetCacheFilePath();
+};
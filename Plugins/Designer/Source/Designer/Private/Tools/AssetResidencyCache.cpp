@@ -0,0 +1,149 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "AssetResidencyCache.h"
+#include "DesignerModule.h"
+
+#include "Editor/UnrealEd/Classes/ActorFactories/ActorFactory.h"
+#include "UObject/GCObject.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Residency Cache Assets"), STAT_DesignerResidencyCacheAssets, STATGROUP_Designer);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Residency Cache Hits"), STAT_DesignerResidencyCacheHits, STATGROUP_Designer);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Residency Cache Misses"), STAT_DesignerResidencyCacheMisses, STATGROUP_Designer);
+DECLARE_MEMORY_STAT(TEXT("Residency Cache Memory"), STAT_DesignerResidencyCacheMemory, STATGROUP_Designer);
+
+FAssetResidencyCache::FAssetResidencyCache()
+	: UseCounter(0)
+	, TotalSizeBytes(0)
+	, MaxAssets(32)
+	, BudgetBytes(512ll * 1024 * 1024)
+	, HitCount(0)
+	, MissCount(0)
+{
+
+}
+
+void FAssetResidencyCache::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	for (TPair<FName, FResidencyEntry>& Pair : Entries)
+	{
+		Collector.AddReferencedObject(Pair.Value.Asset);
+		Collector.AddReferencedObject(Pair.Value.ActorFactory);
+	}
+}
+
+void FAssetResidencyCache::SetLimits(int32 InMaxAssets, int64 InBudgetBytes)
+{
+	MaxAssets = FMath::Max(InMaxAssets, 0);
+	BudgetBytes = FMath::Max<int64>(InBudgetBytes, 0);
+	EvictToLimits();
+}
+
+UObject* FAssetResidencyCache::Find(const FAssetData& AssetData, UActorFactory** OutActorFactory)
+{
+	FResidencyEntry* Entry = Entries.Find(AssetData.ObjectPath);
+
+	// The garbage collector clears references to assets which are force deleted.
+	if (Entry == nullptr || Entry->Asset == nullptr)
+	{
+		MissCount++;
+		UpdateStats();
+		return nullptr;
+	}
+
+	HitCount++;
+	Entry->LastUseIndex = ++UseCounter;
+
+	if (OutActorFactory != nullptr)
+	{
+		*OutActorFactory = Entry->ActorFactory;
+	}
+
+	UpdateStats();
+	return Entry->Asset;
+}
+
+void FAssetResidencyCache::Add(const FAssetData& AssetData, UObject* Asset, UActorFactory* ActorFactory)
+{
+	if (Asset == nullptr || MaxAssets == 0)
+		return;
+
+	FResidencyEntry& Entry = Entries.FindOrAdd(AssetData.ObjectPath);
+	TotalSizeBytes -= Entry.SizeBytes;
+
+	Entry.Asset = Asset;
+	Entry.ActorFactory = ActorFactory;
+	Entry.SizeBytes = Asset->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+	Entry.LastUseIndex = ++UseCounter;
+
+	TotalSizeBytes += Entry.SizeBytes;
+
+	EvictToLimits();
+	UpdateStats();
+}
+
+void FAssetResidencyCache::Empty()
+{
+	Entries.Empty();
+	TotalSizeBytes = 0;
+	UpdateStats();
+}
+
+void FAssetResidencyCache::ResetCounters()
+{
+	HitCount = 0;
+	MissCount = 0;
+	UpdateStats();
+}
+
+void FAssetResidencyCache::EvictToLimits()
+{
+	// The cache only holds a few dozen assets, so a linear search for the least recently used entry is cheap.
+	while (Entries.Num() > 0 && (Entries.Num() > MaxAssets || TotalSizeBytes > BudgetBytes))
+	{
+		FName LeastRecentlyUsedKey = NAME_None;
+		uint64 LeastRecentlyUsedIndex = MAX_uint64;
+		for (const TPair<FName, FResidencyEntry>& Pair : Entries)
+		{
+			if (Pair.Value.LastUseIndex < LeastRecentlyUsedIndex)
+			{
+				LeastRecentlyUsedIndex = Pair.Value.LastUseIndex;
+				LeastRecentlyUsedKey = Pair.Key;
+			}
+		}
+
+		TotalSizeBytes -= Entries.FindChecked(LeastRecentlyUsedKey).SizeBytes;
+		Entries.Remove(LeastRecentlyUsedKey);
+	}
+
+	UpdateStats();
+}
+
+void FAssetResidencyCache::UpdateStats() const
+{
+	SET_DWORD_STAT(STAT_DesignerResidencyCacheAssets, Entries.Num());
+	SET_DWORD_STAT(STAT_DesignerResidencyCacheHits, HitCount);
+	SET_DWORD_STAT(STAT_DesignerResidencyCacheMisses, MissCount);
+	SET_MEMORY_STAT(STAT_DesignerResidencyCacheMemory, TotalSizeBytes);
+}
@@ -0,0 +1,104 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+
+class UActorFactory;
+class FReferenceCollector;
+
+/**
+ * Keeps the most recently placed assets and their actor factory loaded, so picking them again does not load them again.
+ * The least recently used assets are released when the asset count or the memory budget is exceeded.
+ */
+class FAssetResidencyCache
+{
+private:
+	struct FResidencyEntry
+	{
+		UObject* Asset = nullptr;
+
+		UActorFactory* ActorFactory = nullptr;
+
+		/** The estimated memory used by the asset */
+		int64 SizeBytes = 0;
+
+		/** The use counter value when this entry was last used, the lowest value is the least recently used */
+		uint64 LastUseIndex = 0;
+	};
+
+	/** The cached assets per object path */
+	TMap<FName, FResidencyEntry> Entries;
+
+	/** Increased every time an entry is used */
+	uint64 UseCounter;
+
+	/** The total estimated memory used by all cached assets */
+	int64 TotalSizeBytes;
+
+	int32 MaxAssets;
+
+	int64 BudgetBytes;
+
+	uint32 HitCount;
+
+	uint32 MissCount;
+
+public:
+	FAssetResidencyCache();
+
+	/** Keep the cached assets from being garbage collected */
+	void AddReferencedObjects(FReferenceCollector& Collector);
+
+	/** Change the limits of the cache, evicting entries which don't fit anymore */
+	void SetLimits(int32 InMaxAssets, int64 InBudgetBytes);
+
+	/** Returns the cached asset and marks it as most recently used. Counts as a hit or a miss. */
+	UObject* Find(const FAssetData& AssetData, UActorFactory** OutActorFactory = nullptr);
+
+	/** Add or refresh a placed asset and mark it as most recently used */
+	void Add(const FAssetData& AssetData, UObject* Asset, UActorFactory* ActorFactory);
+
+	/** Release all cached assets, the counters are kept */
+	void Empty();
+
+	FORCEINLINE int32 Num() const { return Entries.Num(); }
+
+	FORCEINLINE int64 GetTotalSizeBytes() const { return TotalSizeBytes; }
+
+	FORCEINLINE uint32 GetHitCount() const { return HitCount; }
+
+	FORCEINLINE uint32 GetMissCount() const { return MissCount; }
+
+	/** Reset the hit and miss counters */
+	void ResetCounters();
+
+private:
+	/** Remove the least recently used entries until the cache fits within its limits */
+	void EvictToLimits();
+
+	void UpdateStats() const;
+};
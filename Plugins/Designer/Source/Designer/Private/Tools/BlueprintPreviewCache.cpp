@@ -0,0 +1,223 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "BlueprintPreviewCache.h"
+#include "DesignerModule.h"
+#include "DesignerSettings.h"
+#include "Tools/AssetBoundsUtils.h"
+
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/World.h"
+#include "Materials/MaterialInterface.h"
+#include "UObject/GCObject.h"
+#include "UObject/Package.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Blueprint Preview Classes"), STAT_DesignerBlueprintPreviewClasses, STATGROUP_Designer);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Blueprint Preview Hits"), STAT_DesignerBlueprintPreviewHits, STATGROUP_Designer);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Blueprint Preview Misses"), STAT_DesignerBlueprintPreviewMisses, STATGROUP_Designer);
+
+FBlueprintPreviewCache::FBlueprintPreviewCache()
+	: UseCounter(0)
+	, MaxClasses(16)
+	, HitCount(0)
+	, MissCount(0)
+{
+
+}
+
+void FBlueprintPreviewCache::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	for (TPair<TObjectKey<UClass>, FBlueprintPreview>& Pair : Previews)
+	{
+		Collector.AddReferencedObjects(Pair.Value.Components);
+	}
+}
+
+bool FBlueprintPreviewCache::Prepare(const UClass* ActorClass, UMaterialInterface* Material)
+{
+	const FBlueprintPreview* Preview = FindOrBuild(ActorClass, Material);
+	return Preview != nullptr && Preview->Components.Num() > 0;
+}
+
+bool FBlueprintPreviewCache::Show(UWorld* World, const UClass* ActorClass, UMaterialInterface* Material, const FPreviewRenderPolicy& RenderPolicy, const FTransform& ActorTransform)
+{
+	Hide();
+
+	if (World == nullptr)
+		return false;
+
+	FBlueprintPreview* Preview = FindOrBuild(ActorClass, Material);
+	if (Preview == nullptr || Preview->Components.Num() == 0)
+		return false;
+
+	for (int32 Index = 0; Index < Preview->Components.Num(); ++Index)
+	{
+		UStaticMeshComponent* Component = Preview->Components[Index];
+		RenderPolicy.ApplyTo(Component);
+		Component->SetWorldTransform(Preview->ComponentToActorTransforms[Index] * ActorTransform);
+		Component->RegisterComponentWithWorld(World);
+	}
+
+	ShownClass = ActorClass;
+	return true;
+}
+
+void FBlueprintPreviewCache::SetTransform(const FTransform& ActorTransform)
+{
+	FBlueprintPreview* Preview = Previews.Find(ShownClass);
+	if (Preview == nullptr)
+		return;
+
+	for (int32 Index = 0; Index < Preview->Components.Num(); ++Index)
+	{
+		Preview->Components[Index]->SetWorldTransform(Preview->ComponentToActorTransforms[Index] * ActorTransform);
+	}
+}
+
+void FBlueprintPreviewCache::Hide()
+{
+	if (FBlueprintPreview* Preview = Previews.Find(ShownClass))
+	{
+		for (UStaticMeshComponent* Component : Preview->Components)
+		{
+			if (IsValid(Component) && Component->IsRegistered())
+			{
+				Component->UnregisterComponent();
+			}
+		}
+	}
+
+	ShownClass = TObjectKey<UClass>();
+}
+
+void FBlueprintPreviewCache::Empty()
+{
+	Hide();
+	Previews.Empty();
+	UpdateStats();
+}
+
+FBlueprintPreviewCache::FBlueprintPreview* FBlueprintPreviewCache::FindOrBuild(const UClass* ActorClass, UMaterialInterface* Material)
+{
+	if (ActorClass == nullptr)
+		return nullptr;
+
+	if (FBlueprintPreview* Preview = Previews.Find(ActorClass))
+	{
+		HitCount++;
+		Preview->LastUseIndex = ++UseCounter;
+		UpdateStats();
+		return Preview;
+	}
+
+	MissCount++;
+
+	TArray<FPrimitiveComponentTemplate> Templates;
+	FAssetBoundsUtils::GatherPrimitiveComponentTemplates(ActorClass, Templates);
+
+	FBlueprintPreview& Preview = Previews.Add(ActorClass);
+	Preview.LastUseIndex = ++UseCounter;
+
+	for (const FPrimitiveComponentTemplate& Template : Templates)
+	{
+		// Only the meshes are needed, the materials are replaced by the preview material anyway.
+		// Other primitives like skeletal meshes and particles need an owner to render, those are left out of the preview.
+		const UStaticMeshComponent* StaticMeshTemplate = Cast<UStaticMeshComponent>(Template.Template);
+		if (StaticMeshTemplate == nullptr || StaticMeshTemplate->GetStaticMesh() == nullptr)
+			continue;
+
+		const UInstancedStaticMeshComponent* InstancedTemplate = Cast<UInstancedStaticMeshComponent>(StaticMeshTemplate);
+
+		UStaticMeshComponent* Component = InstancedTemplate != nullptr
+			? NewObject<UInstancedStaticMeshComponent>(GetTransientPackage(), NAME_None, RF_Transient)
+			: NewObject<UStaticMeshComponent>(GetTransientPackage(), NAME_None, RF_Transient);
+
+		Component->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+		Component->SetMobility(EComponentMobility::Movable);
+		Component->SetAbsolute(true, true, true);
+		Component->CastShadow = false;
+		Component->bSelectable = false;
+		Component->SetStaticMesh(StaticMeshTemplate->GetStaticMesh());
+
+		if (InstancedTemplate != nullptr)
+		{
+			TArray<FTransform> InstanceTransforms;
+			InstanceTransforms.Reserve(InstancedTemplate->PerInstanceSMData.Num());
+			for (const FInstancedStaticMeshInstanceData& InstanceData : InstancedTemplate->PerInstanceSMData)
+			{
+				InstanceTransforms.Add(FTransform(InstanceData.Transform));
+			}
+
+			CastChecked<UInstancedStaticMeshComponent>(Component)->AddInstances(InstanceTransforms, false);
+		}
+
+		const int32 MaterialCount = Component->GetNumMaterials();
+		for (int32 MaterialIndex = 0; MaterialIndex < MaterialCount; MaterialIndex++)
+		{
+			Component->SetMaterial(MaterialIndex, Material);
+		}
+
+		Preview.Components.Add(Component);
+		Preview.ComponentToActorTransforms.Add(Template.ComponentToActor);
+	}
+
+	UE_LOG(LogDesigner, Log, TEXT("BlueprintPreviewCache: Built preview of %s with %d components."), *ActorClass->GetName(), Preview.Components.Num());
+
+	// Evicting might reallocate the map, so the preview is looked up again.
+	EvictToLimit();
+	return Previews.Find(ActorClass);
+}
+
+void FBlueprintPreviewCache::EvictToLimit()
+{
+	while (Previews.Num() > MaxClasses)
+	{
+		TObjectKey<UClass> LeastRecentlyUsedKey;
+		uint64 LeastRecentlyUsedIndex = MAX_uint64;
+		for (const TPair<TObjectKey<UClass>, FBlueprintPreview>& Pair : Previews)
+		{
+			if (Pair.Key != ShownClass && Pair.Value.LastUseIndex < LeastRecentlyUsedIndex)
+			{
+				LeastRecentlyUsedIndex = Pair.Value.LastUseIndex;
+				LeastRecentlyUsedKey = Pair.Key;
+			}
+		}
+
+		if (LeastRecentlyUsedIndex == MAX_uint64)
+			break;
+
+		Previews.Remove(LeastRecentlyUsedKey);
+	}
+
+	UpdateStats();
+}
+
+void FBlueprintPreviewCache::UpdateStats() const
+{
+	SET_DWORD_STAT(STAT_DesignerBlueprintPreviewClasses, Previews.Num());
+	SET_DWORD_STAT(STAT_DesignerBlueprintPreviewHits, HitCount);
+	SET_DWORD_STAT(STAT_DesignerBlueprintPreviewMisses, MissCount);
+}
@@ -0,0 +1,107 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class FReferenceCollector;
+struct FPreviewRenderPolicy;
+class UMaterialInterface;
+class UStaticMeshComponent;
+class UWorld;
+
+/**
+ * Builds render only previews of blueprint classes from their native components and construction script templates, without running the construction scripts.
+ * The previews are cached per class and reused every time the same class is previewed.
+ */
+class FBlueprintPreviewCache
+{
+private:
+	struct FBlueprintPreview
+	{
+		/** Standalone mesh components without owner, one for every visible mesh component of the class */
+		TArray<UStaticMeshComponent*> Components;
+
+		/** The transform of each component relative to the actor */
+		TArray<FTransform> ComponentToActorTransforms;
+
+		/** The use counter value when this preview was last used, the lowest value is the least recently used */
+		uint64 LastUseIndex = 0;
+	};
+
+	/** The cached previews per blueprint class. A recompiled blueprint keeps its class, so the cache has to be emptied when a blueprint is compiled. */
+	TMap<TObjectKey<UClass>, FBlueprintPreview> Previews;
+
+	/** The class of the preview which is currently registered with the world */
+	TObjectKey<UClass> ShownClass;
+
+	/** Increased every time a preview is used */
+	uint64 UseCounter;
+
+	int32 MaxClasses;
+
+	uint32 HitCount;
+
+	uint32 MissCount;
+
+public:
+	FBlueprintPreviewCache();
+
+	/** Keep the preview components from being garbage collected */
+	void AddReferencedObjects(FReferenceCollector& Collector);
+
+	/** Build the preview of the class if it isn't cached yet. Returns false if the class has no mesh components to preview. */
+	bool Prepare(const UClass* ActorClass, UMaterialInterface* Material);
+
+	/** Register the preview components of the class with the world. Returns false if the class has no mesh components to preview. */
+	bool Show(UWorld* World, const UClass* ActorClass, UMaterialInterface* Material, const FPreviewRenderPolicy& RenderPolicy, const FTransform& ActorTransform);
+
+	/** Move the shown preview */
+	void SetTransform(const FTransform& ActorTransform);
+
+	/** Unregister the shown preview, the components are kept for the next time the class is previewed */
+	void Hide();
+
+	FORCEINLINE bool IsShown() const { return ShownClass != TObjectKey<UClass>(); }
+
+	/** Hide and release all cached previews, the counters are kept */
+	void Empty();
+
+	FORCEINLINE int32 Num() const { return Previews.Num(); }
+
+	FORCEINLINE uint32 GetHitCount() const { return HitCount; }
+
+	FORCEINLINE uint32 GetMissCount() const { return MissCount; }
+
+private:
+	/** Returns the cached preview of the class, building it when it isn't cached yet */
+	FBlueprintPreview* FindOrBuild(const UClass* ActorClass, UMaterialInterface* Material);
+
+	/** Remove the least recently used previews which are not shown until the cache fits within its limit */
+	void EvictToLimit();
+
+	void UpdateStats() const;
+};
@@ -0,0 +1,410 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "LandscapeHeightfieldCache.h"
+#include "DesignerModule.h"
+
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "LandscapeDataAccess.h"
+#include "LandscapeHeightfieldCollisionComponent.h"
+#include "LandscapeProxy.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Landscape Heightfield Tiles"), STAT_DesignerLandscapeHeightfieldTiles, STATGROUP_Designer);
+DECLARE_CYCLE_STAT(TEXT("Landscape Heightfield Raycast"), STAT_DesignerLandscapeHeightfieldRaycast, STATGROUP_Designer);
+
+namespace
+{
+	/** Avoids infinities in the slab test, which turn into NaN when the ray starts on the plane of a box */
+	FORCEINLINE float SafeInverse(float Value)
+	{
+		return 1.F / (FMath::Abs(Value) > SMALL_NUMBER ? Value : (Value < 0.F ? -SMALL_NUMBER : SMALL_NUMBER));
+	}
+
+	/** Möller-Trumbore, both sides of the triangle are hit */
+	FORCEINLINE bool IntersectTriangle(const FVector& Origin, const FVector& Direction, const FVector& V0, const FVector& V1, const FVector& V2, float MaxDistance, float& OutDistance)
+	{
+		const FVector Edge1 = V1 - V0;
+		const FVector Edge2 = V2 - V0;
+		const FVector P = FVector::CrossProduct(Direction, Edge2);
+		const double Determinant = FVector::DotProduct(Edge1, P);
+		if (FMath::Abs(Determinant) < SMALL_NUMBER)
+			return false;
+
+		const double InvDeterminant = 1.0 / Determinant;
+		const FVector T = Origin - V0;
+		const double U = FVector::DotProduct(T, P) * InvDeterminant;
+		if (U < 0.0 || U > 1.0)
+			return false;
+
+		const FVector Q = FVector::CrossProduct(T, Edge1);
+		const double V = FVector::DotProduct(Direction, Q) * InvDeterminant;
+		if (V < 0.0 || U + V > 1.0)
+			return false;
+
+		const double Distance = FVector::DotProduct(Edge2, Q) * InvDeterminant;
+		if (Distance < 0.0 || Distance >= MaxDistance)
+			return false;
+
+		OutDistance = Distance;
+		return true;
+	}
+}
+
+FLandscapeHeightfieldCache::FLandscapeHeightfieldCache()
+	: bIsDirty(false)
+{
+
+}
+
+bool FLandscapeHeightfieldCache::Raycast(const UWorld* InWorld, const FVector& RayOrigin, const FVector& RayDirection, float MaxDistance, FActorPositionTraceResult& OutResult)
+{
+	SCOPE_CYCLE_COUNTER(STAT_DesignerLandscapeHeightfieldRaycast);
+
+	if (InWorld == nullptr)
+		return false;
+
+	if (bIsDirty || World.Get() != InWorld)
+	{
+		Build(InWorld);
+	}
+
+	TArray<int32, TInlineAllocator<4>> StaleTileIndices;
+	float HitDistance;
+	FVector HitNormal;
+	int32 HitTileIndex = RaycastTiles(RayOrigin, RayDirection, MaxDistance, StaleTileIndices, HitDistance, HitNormal);
+
+	// Sculpting updates the collision heights of the components under the brush, only those are gathered again before the ray is traced once more.
+	if (StaleTileIndices.Num() > 0)
+	{
+		if (!RefreshTiles(StaleTileIndices))
+			return false;
+
+		StaleTileIndices.Reset();
+		HitTileIndex = RaycastTiles(RayOrigin, RayDirection, MaxDistance, StaleTileIndices, HitDistance, HitNormal);
+
+		// The stale tiles were skipped, so the hit may be wrong. Let the general trace handle this ray.
+		if (StaleTileIndices.Num() > 0)
+			return false;
+	}
+
+	if (HitTileIndex == INDEX_NONE)
+		return false;
+
+	OutResult.State = FActorPositionTraceResult::HitSuccess;
+	OutResult.Location = RayOrigin + RayDirection * HitDistance;
+	OutResult.SurfaceNormal = HitNormal;
+	OutResult.HitActor = Tiles[HitTileIndex].Component->GetOwner();
+	return true;
+}
+
+int32 FLandscapeHeightfieldCache::RaycastTiles(const FVector& RayOrigin, const FVector& RayDirection, float MaxDistance, TArray<int32, TInlineAllocator<4>>& OutStaleTileIndices, float& OutDistance, FVector& OutNormal) const
+{
+	if (Hierarchy.IsEmpty())
+		return INDEX_NONE;
+
+	const FVector3f Origin = (FVector3f)RayOrigin;
+	const FVector3f InvDirection(SafeInverse((float)RayDirection.X), SafeInverse((float)RayDirection.Y), SafeInverse((float)RayDirection.Z));
+
+	float ClosestDistance = MaxDistance;
+	int32 HitTileIndex = INDEX_NONE;
+
+	TArray<int32, TInlineAllocator<64>> NodeStack;
+	NodeStack.Add(0);
+
+	while (NodeStack.Num() > 0)
+	{
+		const FBoundingVolumeHierarchy::FNode& Node = Hierarchy.Nodes[NodeStack.Pop(false)];
+
+		// Slab test against the tile bounds.
+		const FVector3f T1 = (Node.Bounds.Min - Origin) * InvDirection;
+		const FVector3f T2 = (Node.Bounds.Max - Origin) * InvDirection;
+		const float TMin = FMath::Max3(FMath::Min(T1.X, T2.X), FMath::Min(T1.Y, T2.Y), FMath::Max(FMath::Min(T1.Z, T2.Z), 0.F));
+		const float TMax = FMath::Min3(FMath::Max(T1.X, T2.X), FMath::Max(T1.Y, T2.Y), FMath::Min(FMath::Max(T1.Z, T2.Z), ClosestDistance));
+		if (TMin > TMax)
+			continue;
+
+		if (Node.NumPrimitives == 0)
+		{
+			NodeStack.Add(Node.FirstIndex);
+			NodeStack.Add(Node.FirstIndex + 1);
+			continue;
+		}
+
+		for (int32 Index = Node.FirstIndex; Index < Node.FirstIndex + Node.NumPrimitives; Index++)
+		{
+			const int32 TileIndex = Hierarchy.PrimitiveIndices[Index];
+			const FHeightfieldTile& Tile = Tiles[TileIndex];
+
+			// Sculpting updates the collision heights without moving the landscape.
+			const ULandscapeHeightfieldCollisionComponent* Component = Tile.Component.Get();
+			if (Component == nullptr || Component->HeightfieldGuid != Tile.HeightfieldGuid)
+			{
+				OutStaleTileIndices.Add(TileIndex);
+				continue;
+			}
+
+			float Distance;
+			FVector Normal;
+			if (RaycastTile(Tile, RayOrigin, RayDirection, ClosestDistance, Distance, Normal))
+			{
+				ClosestDistance = Distance;
+				HitTileIndex = TileIndex;
+				OutNormal = Normal;
+			}
+		}
+	}
+
+	OutDistance = ClosestDistance;
+	return HitTileIndex;
+}
+
+bool FLandscapeHeightfieldCache::RefreshTiles(TArrayView<const int32> TileIndices)
+{
+	for (const int32 TileIndex : TileIndices)
+	{
+		// A deleted component leaves a gap in the tiles, they are all gathered again by the next ray.
+		FHeightfieldTile& Tile = Tiles[TileIndex];
+		if (!GatherTile(Tile.Component.Get(), Tile))
+		{
+			bIsDirty = true;
+			return false;
+		}
+	}
+
+	// The heights may have been raised or lowered past the bounds of the tile.
+	BuildHierarchy();
+	return true;
+}
+
+void FLandscapeHeightfieldCache::NotifyActorChanged(const AActor* Actor)
+{
+	if (Actor != nullptr && Actor->IsA<ALandscapeProxy>())
+	{
+		bIsDirty = true;
+	}
+}
+
+void FLandscapeHeightfieldCache::Empty()
+{
+	World.Reset();
+	Tiles.Empty();
+	Hierarchy = FBoundingVolumeHierarchy();
+	bIsDirty = false;
+
+	SET_DWORD_STAT(STAT_DesignerLandscapeHeightfieldTiles, 0);
+}
+
+void FLandscapeHeightfieldCache::Build(const UWorld* InWorld)
+{
+	Empty();
+	World = InWorld;
+
+	for (TActorIterator<ALandscapeProxy> LandscapeIterator(const_cast<UWorld*>(InWorld)); LandscapeIterator; ++LandscapeIterator)
+	{
+		for (const ULandscapeHeightfieldCollisionComponent* Component : LandscapeIterator->CollisionComponents)
+		{
+			FHeightfieldTile Tile;
+			if (GatherTile(Component, Tile))
+			{
+				Tiles.Add(MoveTemp(Tile));
+			}
+		}
+	}
+
+	BuildHierarchy();
+}
+
+void FLandscapeHeightfieldCache::BuildHierarchy()
+{
+	TArray<FBox3f> TileBounds;
+	TileBounds.Reserve(Tiles.Num());
+	for (const FHeightfieldTile& Tile : Tiles)
+	{
+		TileBounds.Add(Tile.Bounds);
+	}
+
+	Hierarchy.Build(TileBounds, 1);
+
+	SET_DWORD_STAT(STAT_DesignerLandscapeHeightfieldTiles, Tiles.Num());
+}
+
+bool FLandscapeHeightfieldCache::GatherTile(const ULandscapeHeightfieldCollisionComponent* Component, FHeightfieldTile& OutTile)
+{
+	if (!IsValid(Component) || !Component->IsRegistered() || !Component->IsCollisionEnabled() || Component->CollisionSizeQuads <= 0)
+		return false;
+
+	const int32 NumVertices = FMath::Square(Component->CollisionSizeQuads + 1);
+
+	// The complex heights come first, the simple collision heights may follow them.
+	FWordBulkData& CollisionHeightData = const_cast<ULandscapeHeightfieldCollisionComponent*>(Component)->CollisionHeightData;
+	if (CollisionHeightData.GetElementCount() < NumVertices)
+		return false;
+
+	OutTile.Component = Component;
+	OutTile.HeightfieldGuid = Component->HeightfieldGuid;
+	OutTile.ComponentToWorld = Component->GetComponentTransform();
+	OutTile.NumQuads = Component->CollisionSizeQuads;
+	OutTile.QuadSize = Component->CollisionScale;
+	OutTile.Heights.SetNumUninitialized(NumVertices);
+
+	float MinHeight = MAX_flt;
+	float MaxHeight = -MAX_flt;
+
+	const uint16* Heights = static_cast<const uint16*>(CollisionHeightData.LockReadOnly());
+	for (int32 Index = 0; Index < NumVertices; Index++)
+	{
+		const float LocalHeight = LandscapeDataAccess::GetLocalHeight(Heights[Index]);
+		OutTile.Heights[Index] = LocalHeight;
+		MinHeight = FMath::Min(MinHeight, LocalHeight);
+		MaxHeight = FMath::Max(MaxHeight, LocalHeight);
+	}
+	CollisionHeightData.Unlock();
+
+	// The collision has a hole where the visibility layer is the dominant layer of the first vertex of a quad.
+	OutTile.Holes.Init(false, FMath::Square(OutTile.NumQuads));
+	FByteBulkData& DominantLayerData = const_cast<ULandscapeHeightfieldCollisionComponent*>(Component)->DominantLayerData;
+	const int32 HoleLayerIndex = ALandscapeProxy::VisibilityLayer != nullptr ? Component->ComponentLayerInfos.IndexOfByKey(ALandscapeProxy::VisibilityLayer) : INDEX_NONE;
+	if (HoleLayerIndex != INDEX_NONE && DominantLayerData.GetElementCount() >= NumVertices)
+	{
+		const uint8* DominantLayers = static_cast<const uint8*>(DominantLayerData.LockReadOnly());
+		for (int32 QuadY = 0; QuadY < OutTile.NumQuads; QuadY++)
+		{
+			for (int32 QuadX = 0; QuadX < OutTile.NumQuads; QuadX++)
+			{
+				OutTile.Holes[QuadY * OutTile.NumQuads + QuadX] = DominantLayers[QuadY * (OutTile.NumQuads + 1) + QuadX] == HoleLayerIndex;
+			}
+		}
+		DominantLayerData.Unlock();
+	}
+
+	const float LocalSize = OutTile.NumQuads * OutTile.QuadSize;
+	const FBox LocalBounds(FVector(0.F, 0.F, MinHeight), FVector(LocalSize, LocalSize, MaxHeight));
+	const FBox WorldBounds = LocalBounds.TransformBy(OutTile.ComponentToWorld);
+	OutTile.Bounds = FBox3f((FVector3f)WorldBounds.Min, (FVector3f)WorldBounds.Max);
+
+	return true;
+}
+
+bool FLandscapeHeightfieldCache::RaycastTile(const FHeightfieldTile& Tile, const FVector& RayOrigin, const FVector& RayDirection, float MaxDistance, float& OutDistance, FVector& OutNormal)
+{
+	// Walk the quads in the space of the tile, with a quad being one unit.
+	const FVector LocalStart = Tile.ComponentToWorld.InverseTransformPosition(RayOrigin) / FVector(Tile.QuadSize, Tile.QuadSize, 1.F);
+	const FVector LocalEnd = Tile.ComponentToWorld.InverseTransformPosition(RayOrigin + RayDirection * MaxDistance) / FVector(Tile.QuadSize, Tile.QuadSize, 1.F);
+	const FVector2D Delta(LocalEnd.X - LocalStart.X, LocalEnd.Y - LocalStart.Y);
+
+	// Clip the segment to the tile.
+	double SegmentStart = 0.0;
+	double SegmentEnd = 1.0;
+	for (int32 Axis = 0; Axis < 2; Axis++)
+	{
+		const double Start = Axis == 0 ? LocalStart.X : LocalStart.Y;
+		const double AxisDelta = Axis == 0 ? Delta.X : Delta.Y;
+		if (FMath::Abs(AxisDelta) < SMALL_NUMBER)
+		{
+			if (Start < 0.0 || Start > Tile.NumQuads)
+				return false;
+			continue;
+		}
+
+		double T0 = (0.0 - Start) / AxisDelta;
+		double T1 = (Tile.NumQuads - Start) / AxisDelta;
+		if (T0 > T1)
+		{
+			Swap(T0, T1);
+		}
+
+		SegmentStart = FMath::Max(SegmentStart, T0);
+		SegmentEnd = FMath::Min(SegmentEnd, T1);
+	}
+
+	if (SegmentStart > SegmentEnd)
+		return false;
+
+	const double EntryX = LocalStart.X + Delta.X * SegmentStart;
+	const double EntryY = LocalStart.Y + Delta.Y * SegmentStart;
+	int32 QuadX = FMath::Clamp(FMath::FloorToInt(EntryX), 0, Tile.NumQuads - 1);
+	int32 QuadY = FMath::Clamp(FMath::FloorToInt(EntryY), 0, Tile.NumQuads - 1);
+
+	const int32 StepX = Delta.X > 0.0 ? 1 : -1;
+	const int32 StepY = Delta.Y > 0.0 ? 1 : -1;
+	const double DeltaSegmentX = FMath::Abs(Delta.X) > SMALL_NUMBER ? FMath::Abs(1.0 / Delta.X) : BIG_NUMBER;
+	const double DeltaSegmentY = FMath::Abs(Delta.Y) > SMALL_NUMBER ? FMath::Abs(1.0 / Delta.Y) : BIG_NUMBER;
+	double NextSegmentX = FMath::Abs(Delta.X) > SMALL_NUMBER ? SegmentStart + ((StepX > 0 ? QuadX + 1 : QuadX) - EntryX) / Delta.X : BIG_NUMBER;
+	double NextSegmentY = FMath::Abs(Delta.Y) > SMALL_NUMBER ? SegmentStart + ((StepY > 0 ? QuadY + 1 : QuadY) - EntryY) / Delta.Y : BIG_NUMBER;
+
+	const FVector LandscapeUp = Tile.ComponentToWorld.TransformVectorNoScale(FVector::UpVector);
+
+	// The quads are visited in the order the ray passes over them, so the first hit is the closest.
+	while (QuadX >= 0 && QuadX < Tile.NumQuads && QuadY >= 0 && QuadY < Tile.NumQuads)
+	{
+		// The ray passes through holes on to the next quad.
+		if (!Tile.Holes[QuadY * Tile.NumQuads + QuadX])
+		{
+			const FVector V00 = Tile.ComponentToWorld.TransformPosition(Tile.GetLocalVertex(QuadX, QuadY));
+			const FVector V10 = Tile.ComponentToWorld.TransformPosition(Tile.GetLocalVertex(QuadX + 1, QuadY));
+			const FVector V01 = Tile.ComponentToWorld.TransformPosition(Tile.GetLocalVertex(QuadX, QuadY + 1));
+			const FVector V11 = Tile.ComponentToWorld.TransformPosition(Tile.GetLocalVertex(QuadX + 1, QuadY + 1));
+
+			// The quads are split along the same diagonal as the landscape collision.
+			float Distance;
+			float ClosestDistance = MaxDistance;
+			FVector Normal = FVector::ZeroVector;
+			if (IntersectTriangle(RayOrigin, RayDirection, V00, V11, V10, ClosestDistance, Distance))
+			{
+				ClosestDistance = Distance;
+				Normal = FVector::CrossProduct(V11 - V00, V10 - V00);
+			}
+			if (IntersectTriangle(RayOrigin, RayDirection, V00, V01, V11, ClosestDistance, Distance))
+			{
+				ClosestDistance = Distance;
+				Normal = FVector::CrossProduct(V01 - V00, V11 - V00);
+			}
+
+			if (!Normal.IsZero())
+			{
+				Normal.Normalize();
+				OutNormal = FVector::DotProduct(Normal, LandscapeUp) < 0.0 ? -Normal : Normal;
+				OutDistance = ClosestDistance;
+				return true;
+			}
+		}
+
+		if (FMath::Min(NextSegmentX, NextSegmentY) > SegmentEnd)
+			break;
+
+		if (NextSegmentX < NextSegmentY)
+		{
+			QuadX += StepX;
+			NextSegmentX += DeltaSegmentX;
+		}
+		else
+		{
+			QuadY += StepY;
+			NextSegmentY += DeltaSegmentY;
+		}
+	}
+
+	return false;
+}
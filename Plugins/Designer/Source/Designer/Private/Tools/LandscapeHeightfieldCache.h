@@ -0,0 +1,110 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tools/StaticGeometryBVH.h"
+#include "Editor/UnrealEd/Private/Editor/ActorPositioning.h"
+
+class AActor;
+class ULandscapeHeightfieldCollisionComponent;
+class UWorld;
+
+/**
+ * Copies the collision heights of the landscapes in a world, so the cursor ray can be intersected with the heightfield directly.
+ * Only the heightfield is known, geometry in front of it has to be tested for separately.
+ */
+class FLandscapeHeightfieldCache
+{
+private:
+	/** The heights of a single landscape collision component */
+	struct FHeightfieldTile
+	{
+		TWeakObjectPtr<const ULandscapeHeightfieldCollisionComponent> Component;
+
+		/** Changes whenever the collision heights are updated */
+		FGuid HeightfieldGuid;
+
+		FTransform ComponentToWorld;
+
+		int32 NumQuads = 0;
+
+		/** The size of a quad in component space */
+		float QuadSize = 1.F;
+
+		/** (NumQuads + 1) * (NumQuads + 1) heights in component space */
+		TArray<float> Heights;
+
+		/** NumQuads * NumQuads bits, set for the quads painted with the visibility layer which have no collision */
+		TBitArray<> Holes;
+
+		FBox3f Bounds;
+
+		FORCEINLINE FVector GetLocalVertex(int32 X, int32 Y) const { return FVector(X * QuadSize, Y * QuadSize, Heights[Y * (NumQuads + 1) + X]); }
+	};
+
+	TWeakObjectPtr<const UWorld> World;
+
+	TArray<FHeightfieldTile> Tiles;
+
+	/** The hierarchy over the bounds of the tiles */
+	FBoundingVolumeHierarchy Hierarchy;
+
+	/** Set when a landscape was added, moved or removed, or a collision component was deleted */
+	bool bIsDirty;
+
+public:
+	FLandscapeHeightfieldCache();
+
+	/**
+	 * Intersect the ray with the landscape heightfields and return the closest hit.
+	 * The normal is the normal of the hit heightfield triangle, facing away from the landscape.
+	 */
+	bool Raycast(const UWorld* InWorld, const FVector& RayOrigin, const FVector& RayDirection, float MaxDistance, FActorPositionTraceResult& OutResult);
+
+	/** Gather the heightfields again when a landscape changed */
+	void NotifyActorChanged(const AActor* Actor);
+
+	void Empty();
+
+	FORCEINLINE int32 NumTiles() const { return Tiles.Num(); }
+
+private:
+	void Build(const UWorld* InWorld);
+
+	void BuildHierarchy();
+
+	/** Find the closest tile hit by the ray, tiles whose heights changed since they were gathered are skipped and returned */
+	int32 RaycastTiles(const FVector& RayOrigin, const FVector& RayDirection, float MaxDistance, TArray<int32, TInlineAllocator<4>>& OutStaleTileIndices, float& OutDistance, FVector& OutNormal) const;
+
+	/** Gather the changed tiles again, returns false and dirties the cache when a tile can't be gathered */
+	bool RefreshTiles(TArrayView<const int32> TileIndices);
+
+	/** Copy the collision heights and holes of the component, returns false if they are not available */
+	static bool GatherTile(const ULandscapeHeightfieldCollisionComponent* Component, FHeightfieldTile& OutTile);
+
+	/** Walk the quads of the tile the ray passes over in order, returns the distance of the first hit */
+	static bool RaycastTile(const FHeightfieldTile& Tile, const FVector& RayOrigin, const FVector& RayDirection, float MaxDistance, float& OutDistance, FVector& OutNormal);
+};
@@ -0,0 +1,190 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PlaceableAssetIndex.h"
+#include "DesignerModule.h"
+
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "AssetSelection.h"
+#include "Editor/UnrealEd/Classes/ActorFactories/ActorFactory.h"
+#include "Engine/Blueprint.h"
+
+FPlaceableAssetIndex::FPlaceableAssetIndex()
+{
+
+}
+
+FPlaceableAssetIndex::~FPlaceableAssetIndex()
+{
+	Shutdown();
+}
+
+void FPlaceableAssetIndex::Initialize()
+{
+	if (OnAssetAddedHandle.IsValid())
+		return;
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	OnAssetAddedHandle = AssetRegistry.OnAssetAdded().AddRaw(this, &FPlaceableAssetIndex::OnAssetAdded);
+	OnAssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddRaw(this, &FPlaceableAssetIndex::OnAssetRemoved);
+	OnAssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddRaw(this, &FPlaceableAssetIndex::OnAssetRenamed);
+	OnAssetUpdatedHandle = AssetRegistry.OnAssetUpdated().AddRaw(this, &FPlaceableAssetIndex::OnAssetUpdated);
+}
+
+void FPlaceableAssetIndex::Shutdown()
+{
+	if (OnAssetAddedHandle.IsValid())
+	{
+		// The asset registry might already be unloaded when the editor shuts down.
+		if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry"))
+		{
+			IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+			AssetRegistry.OnAssetAdded().Remove(OnAssetAddedHandle);
+			AssetRegistry.OnAssetRemoved().Remove(OnAssetRemovedHandle);
+			AssetRegistry.OnAssetRenamed().Remove(OnAssetRenamedHandle);
+			AssetRegistry.OnAssetUpdated().Remove(OnAssetUpdatedHandle);
+		}
+
+		OnAssetAddedHandle.Reset();
+		OnAssetRemovedHandle.Reset();
+		OnAssetRenamedHandle.Reset();
+		OnAssetUpdatedHandle.Reset();
+	}
+
+	AssetEntries.Empty();
+	NativeParentClassEntries.Empty();
+}
+
+bool FPlaceableAssetIndex::IsPlaceable(const FAssetData& AssetData)
+{
+	return FindOrAddEntry(AssetData).bPlaceable;
+}
+
+UActorFactory* FPlaceableAssetIndex::FindActorFactory(const FAssetData& AssetData)
+{
+	const FPlaceableEntry& Entry = FindOrAddEntry(AssetData);
+	return Entry.bPlaceable ? Entry.ActorFactory.Get() : nullptr;
+}
+
+const FPlaceableAssetIndex::FPlaceableEntry& FPlaceableAssetIndex::FindOrAddEntry(const FAssetData& AssetData)
+{
+	// Factories can be removed when their module is unloaded, in that case resolve the entry again.
+	FPlaceableEntry* Entry = AssetEntries.Find(AssetData.ObjectPath);
+	if (Entry == nullptr || (Entry->bPlaceable && !Entry->ActorFactory.IsValid()))
+	{
+		Entry = &AssetEntries.Add(AssetData.ObjectPath, ResolveEntry(AssetData));
+	}
+
+	return *Entry;
+}
+
+FPlaceableAssetIndex::FPlaceableEntry FPlaceableAssetIndex::ResolveEntry(const FAssetData& AssetData)
+{
+	FPlaceableEntry Entry;
+
+	if (!AssetData.IsValid())
+		return Entry;
+
+	// Only looks at the asset data, the asset itself is not loaded.
+	UActorFactory* ActorFactory = FActorFactoryAssetProxy::GetFactoryForAsset(AssetData, false);
+	Entry.ActorFactory = ActorFactory;
+	Entry.bPlaceable = ActorFactory != nullptr;
+
+	if (Entry.bPlaceable && AssetData.AssetClass == UBlueprint::StaticClass()->GetFName())
+	{
+		Entry.bPlaceable = IsBlueprintPlaceable(AssetData);
+	}
+
+	return Entry;
+}
+
+bool FPlaceableAssetIndex::IsBlueprintPlaceable(const FAssetData& AssetData)
+{
+	// For blueprints, attempt to determine placeability from its tag information
+	const FName NativeParentClassTag = TEXT("NativeParentClass");
+	const FName ClassFlagsTag = TEXT("ClassFlags");
+
+	bool bPlaceable = true;
+
+	FString TagValue;
+
+	if (AssetData.GetTagValue(NativeParentClassTag, TagValue) && !TagValue.IsEmpty())
+	{
+		// If the native parent class can't be placed, neither can the blueprint. Native classes are shared by many blueprints, so only resolve them once.
+		const FName NativeParentClassKey = FName(*TagValue);
+		if (const bool* bCachedPlaceable = NativeParentClassEntries.Find(NativeParentClassKey))
+		{
+			bPlaceable = *bCachedPlaceable;
+		}
+		else
+		{
+			UObject* Outer = nullptr;
+			ResolveName(Outer, TagValue, false, false);
+			UClass* NativeParentClass = FindObject<UClass>(ANY_PACKAGE, *TagValue);
+
+			bPlaceable = AssetSelectionUtils::IsClassPlaceable(NativeParentClass);
+			NativeParentClassEntries.Add(NativeParentClassKey, bPlaceable);
+		}
+	}
+
+	if (bPlaceable && AssetData.GetTagValue(ClassFlagsTag, TagValue) && !TagValue.IsEmpty())
+	{
+		// Check to see if this class is placeable from its class flags
+		const int32 NotPlaceableFlags = CLASS_NotPlaceable | CLASS_Deprecated | CLASS_Abstract;
+		uint32 ClassFlags = FCString::Atoi(*TagValue);
+
+		bPlaceable = (ClassFlags & NotPlaceableFlags) == CLASS_None;
+	}
+
+	return bPlaceable;
+}
+
+void FPlaceableAssetIndex::OnAssetAdded(const FAssetData& AssetData)
+{
+	// An asset can be recreated at the path of a deleted asset, so never trust an older entry.
+	AssetEntries.Remove(AssetData.ObjectPath);
+}
+
+void FPlaceableAssetIndex::OnAssetRemoved(const FAssetData& AssetData)
+{
+	AssetEntries.Remove(AssetData.ObjectPath);
+}
+
+void FPlaceableAssetIndex::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	const FName OldObjectPathName = FName(*OldObjectPath, FNAME_Find);
+	if (OldObjectPathName != NAME_None)
+	{
+		AssetEntries.Remove(OldObjectPathName);
+	}
+
+	AssetEntries.Remove(AssetData.ObjectPath);
+}
+
+void FPlaceableAssetIndex::OnAssetUpdated(const FAssetData& AssetData)
+{
+	// The tags might have changed when the asset is saved again, like the parent class of a blueprint.
+	AssetEntries.Remove(AssetData.ObjectPath);
+}
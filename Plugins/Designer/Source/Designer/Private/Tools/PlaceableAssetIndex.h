@@ -0,0 +1,91 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+
+class UActorFactory;
+
+/**
+ * Decides whether assets can be placed in the world using only asset registry metadata, so no asset has to be loaded.
+ * Results are cached per asset, the asset registry events keep the cache up to date.
+ */
+class FPlaceableAssetIndex
+{
+private:
+	struct FPlaceableEntry
+	{
+		/** The factory able to place the asset, null when the asset is not placeable */
+		TWeakObjectPtr<UActorFactory> ActorFactory;
+
+		bool bPlaceable = false;
+	};
+
+	/** Placeability per asset object path. Factories match on the path and tags of an asset too, like the basic shapes and skeletal meshes, so the class doesn't decide it. */
+	TMap<FName, FPlaceableEntry> AssetEntries;
+
+	/** Placeability of the native parent classes found in blueprint tags */
+	TMap<FName, bool> NativeParentClassEntries;
+
+	FDelegateHandle OnAssetAddedHandle;
+	FDelegateHandle OnAssetRemovedHandle;
+	FDelegateHandle OnAssetRenamedHandle;
+	FDelegateHandle OnAssetUpdatedHandle;
+
+public:
+	FPlaceableAssetIndex();
+
+	~FPlaceableAssetIndex();
+
+	/** Start listening to the asset registry events */
+	void Initialize();
+
+	/** Stop listening to the asset registry events and clear all cached results */
+	void Shutdown();
+
+	/** Returns true if the asset can be placed in the world. Never loads the asset. */
+	bool IsPlaceable(const FAssetData& AssetData);
+
+	/** Returns the actor factory used to place the asset or null if the asset is not placeable. Never loads the asset. */
+	UActorFactory* FindActorFactory(const FAssetData& AssetData);
+
+private:
+	const FPlaceableEntry& FindOrAddEntry(const FAssetData& AssetData);
+
+	/** Resolve the placeability of the asset from its class and tags */
+	FPlaceableEntry ResolveEntry(const FAssetData& AssetData);
+
+	/** Blueprints can only be placed when the native parent class is placeable and the class flags allow it */
+	bool IsBlueprintPlaceable(const FAssetData& AssetData);
+
+	void OnAssetAdded(const FAssetData& AssetData);
+
+	void OnAssetRemoved(const FAssetData& AssetData);
+
+	void OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+
+	void OnAssetUpdated(const FAssetData& AssetData);
+};
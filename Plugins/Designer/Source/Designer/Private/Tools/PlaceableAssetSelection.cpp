@@ -0,0 +1,147 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PlaceableAssetSelection.h"
+#include "PlaceableAssetIndex.h"
+#include "DesignerModule.h"
+
+#include "AssetSelection.h"
+#include "ContentBrowserModule.h"
+
+FPlaceableAssetSelection::FPlaceableAssetSelection(FPlaceableAssetIndex& InPlaceableAssetIndex)
+	: PlaceableAssetIndex(InPlaceableAssetIndex)
+{
+
+}
+
+FPlaceableAssetSelection::~FPlaceableAssetSelection()
+{
+	Shutdown();
+}
+
+void FPlaceableAssetSelection::Initialize()
+{
+	if (OnAssetSelectionChangedHandle.IsValid())
+		return;
+
+	FContentBrowserModule& ContentBrowserModule = FModuleManager::LoadModuleChecked<FContentBrowserModule>("ContentBrowser");
+	OnAssetSelectionChangedHandle = ContentBrowserModule.GetOnAssetSelectionChanged().AddRaw(this, &FPlaceableAssetSelection::OnAssetSelectionChanged);
+
+	TArray<FAssetData> SelectedAssets;
+	AssetSelectionUtils::GetSelectedAssets(SelectedAssets);
+	SetSelectedAssets(SelectedAssets);
+}
+
+void FPlaceableAssetSelection::Shutdown()
+{
+	if (OnAssetSelectionChangedHandle.IsValid())
+	{
+		if (FContentBrowserModule* ContentBrowserModule = FModuleManager::GetModulePtr<FContentBrowserModule>("ContentBrowser"))
+		{
+			ContentBrowserModule->GetOnAssetSelectionChanged().Remove(OnAssetSelectionChangedHandle);
+		}
+
+		OnAssetSelectionChangedHandle.Reset();
+	}
+
+	Assets.Empty();
+	AssetIndices.Empty();
+}
+
+const FAssetData* FPlaceableAssetSelection::PickRandom(const FAssetData& ExcludedAssetData) const
+{
+	if (Assets.Num() == 0)
+		return nullptr;
+
+	const int32* ExcludedIndex = AssetIndices.Find(ExcludedAssetData.ObjectPath);
+	if (ExcludedIndex == nullptr || Assets.Num() == 1)
+	{
+		return &Assets[FMath::RandRange(0, Assets.Num() - 1)];
+	}
+
+	// Pick from all other assets by skipping over the excluded index.
+	int32 RandomIndex = FMath::RandRange(0, Assets.Num() - 2);
+	if (RandomIndex >= *ExcludedIndex)
+	{
+		RandomIndex++;
+	}
+
+	return &Assets[RandomIndex];
+}
+
+void FPlaceableAssetSelection::SetSelectedAssets(const TArray<FAssetData>& SelectedAssets)
+{
+	TSet<FName> SelectedObjectPaths;
+	SelectedObjectPaths.Reserve(SelectedAssets.Num());
+	for (const FAssetData& AssetData : SelectedAssets)
+	{
+		SelectedObjectPaths.Add(AssetData.ObjectPath);
+	}
+
+	// Remove the assets which are no longer selected. Iterate backwards because removing swaps in the last asset.
+	for (int32 Index = Assets.Num() - 1; Index >= 0; Index--)
+	{
+		if (!SelectedObjectPaths.Contains(Assets[Index].ObjectPath))
+		{
+			RemoveAt(Index);
+		}
+	}
+
+	for (const FAssetData& AssetData : SelectedAssets)
+	{
+		if (!Contains(AssetData) && PlaceableAssetIndex.IsPlaceable(AssetData))
+		{
+			Add(AssetData);
+		}
+	}
+
+	OnSelectionChanged.Broadcast();
+}
+
+void FPlaceableAssetSelection::Add(const FAssetData& AssetData)
+{
+	AssetIndices.Add(AssetData.ObjectPath, Assets.Add(AssetData));
+}
+
+void FPlaceableAssetSelection::RemoveAt(int32 Index)
+{
+	const int32 LastIndex = Assets.Num() - 1;
+	AssetIndices.Remove(Assets[Index].ObjectPath);
+
+	if (Index != LastIndex)
+	{
+		AssetIndices.Add(Assets[LastIndex].ObjectPath, Index);
+	}
+
+	Assets.RemoveAtSwap(Index, 1, false);
+}
+
+void FPlaceableAssetSelection::OnAssetSelectionChanged(const TArray<FAssetData>& NewSelectedAssets, bool bIsPrimaryBrowser)
+{
+	// The tool always spawned from the primary content browser, secondary browsers are ignored.
+	if (bIsPrimaryBrowser)
+	{
+		SetSelectedAssets(NewSelectedAssets);
+	}
+}
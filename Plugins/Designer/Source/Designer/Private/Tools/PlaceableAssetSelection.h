@@ -0,0 +1,93 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+
+class FPlaceableAssetIndex;
+
+DECLARE_MULTICAST_DELEGATE(FOnPlaceableAssetSelectionChanged);
+
+/**
+ * The placeable assets selected in the content browser.
+ * Only updated when the content browser selection changes, so picking an asset to spawn does not depend on the selection size.
+ */
+class FPlaceableAssetSelection
+{
+private:
+	/** Used to filter the selected assets which can't be placed */
+	FPlaceableAssetIndex& PlaceableAssetIndex;
+
+	/** The placeable selected assets in no particular order */
+	TArray<FAssetData> Assets;
+
+	/** The index in the Assets array per asset object path */
+	TMap<FName, int32> AssetIndices;
+
+	FDelegateHandle OnAssetSelectionChangedHandle;
+
+	FOnPlaceableAssetSelectionChanged OnSelectionChanged;
+
+public:
+	FPlaceableAssetSelection(FPlaceableAssetIndex& InPlaceableAssetIndex);
+
+	~FPlaceableAssetSelection();
+
+	/** Take a snapshot of the current content browser selection and start listening to selection changes */
+	void Initialize();
+
+	/** Stop listening to selection changes and clear the selection */
+	void Shutdown();
+
+	FORCEINLINE int32 Num() const { return Assets.Num(); }
+
+	FORCEINLINE const TArray<FAssetData>& GetAssets() const { return Assets; }
+
+	FORCEINLINE bool Contains(const FAssetData& AssetData) const { return AssetIndices.Contains(AssetData.ObjectPath); }
+
+	FORCEINLINE bool Contains(const FName& ObjectPath) const { return AssetIndices.Contains(ObjectPath); }
+
+	/** Broadcast after the placeable selection changed */
+	FORCEINLINE FOnPlaceableAssetSelectionChanged& GetOnSelectionChanged() { return OnSelectionChanged; }
+
+	/**
+	 * Pick a random asset from the selection in constant time.
+	 * The excluded asset is only returned when it is the only asset in the selection, so consecutive picks differ.
+	 * Returns null if the selection is empty.
+	 */
+	const FAssetData* PickRandom(const FAssetData& ExcludedAssetData) const;
+
+private:
+	/** Replace the selection with the placeable assets in the new selection */
+	void SetSelectedAssets(const TArray<FAssetData>& SelectedAssets);
+
+	void Add(const FAssetData& AssetData);
+
+	/** Remove the asset by swapping it with the last asset, so removal is constant time */
+	void RemoveAt(int32 Index);
+
+	void OnAssetSelectionChanged(const TArray<FAssetData>& NewSelectedAssets, bool bIsPrimaryBrowser);
+};
@@ -0,0 +1,180 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PlacementTrace.h"
+#include "DesignerModule.h"
+
+#include "Components/ModelComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Volume.h"
+#include "HAL/IConsoleManager.h"
+#include "EditorViewportClient.h"
+#include "LevelEditorViewport.h"
+#include "SceneView.h"
+
+DECLARE_CYCLE_STAT(TEXT("Placement Trace"), STAT_DesignerPlacementTrace, STATGROUP_Designer);
+
+FActorPositionTraceResult FPlacementTrace::Trace(const UWorld* World, const FVector& RayOrigin, const FVector& RayDirection, ECollisionChannel TraceChannel, const TArray<TEnumAsByte<EObjectTypeQuery>>& ObjectTypes, const FEngineShowFlags* ShowFlags, float MaxDistance)
+{
+	SCOPE_CYCLE_COUNTER(STAT_DesignerPlacementTrace);
+
+	FActorPositionTraceResult TraceResult;
+	TraceResult.State = FActorPositionTraceResult::Default;
+
+	if (World == nullptr)
+		return TraceResult;
+
+	const FVector RayEnd = RayOrigin + RayDirection * MaxDistance;
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(DesignerPlacementTrace), true);
+	QueryParams.bReturnPhysicalMaterial = false;
+
+	const FCollisionObjectQueryParams ObjectQueryParams(ObjectTypes);
+
+	// Stop at the first blocking hit, only trace again when it was on something invisible.
+	for (int32 SkippedHits = 0; SkippedHits <= MaxSkippedHits; SkippedHits++)
+	{
+		FHitResult Hit;
+		const bool bHit = ObjectTypes.Num() > 0
+			? World->LineTraceSingleByObjectType(Hit, RayOrigin, RayEnd, ObjectQueryParams, QueryParams)
+			: World->LineTraceSingleByChannel(Hit, RayOrigin, RayEnd, TraceChannel, QueryParams);
+
+		if (!bHit)
+			break;
+
+		if (IsHitValid(Hit, ShowFlags))
+		{
+			TraceResult = MakeTraceResult(Hit);
+			break;
+		}
+
+		QueryParams.AddIgnoredComponent(Hit.GetComponent());
+	}
+
+	return TraceResult;
+}
+
+bool FPlacementTrace::IsHitValid(const FHitResult& Hit, const FEngineShowFlags* ShowFlags)
+{
+	const UPrimitiveComponent* PrimitiveComponent = Hit.GetComponent();
+	if (PrimitiveComponent == nullptr || !PrimitiveComponent->IsVisibleInEditor())
+		return false;
+
+	const AActor* Actor = Hit.GetActor();
+	if (Actor != nullptr && Actor->IsHiddenEd())
+		return false;
+
+	if (ShowFlags != nullptr)
+	{
+		if (!ShowFlags->BSP && PrimitiveComponent->IsA<UModelComponent>())
+			return false;
+
+		if (!ShowFlags->Volumes && Actor != nullptr && Actor->IsA<AVolume>())
+			return false;
+	}
+
+	return true;
+}
+
+FActorPositionTraceResult FPlacementTrace::MakeTraceResult(const FHitResult& Hit)
+{
+	FActorPositionTraceResult TraceResult;
+	TraceResult.State = FActorPositionTraceResult::HitSuccess;
+	TraceResult.Location = Hit.ImpactPoint;
+	TraceResult.SurfaceNormal = Hit.ImpactNormal;
+	TraceResult.HitActor = Hit.GetActor();
+	return TraceResult;
+}
+
+namespace
+{
+	/**
+	 * Compare the placement trace with FActorPositioning for a grid of cursor rays in the active level viewport.
+	 * Usage: Designer.BenchmarkPlacementTrace [RaysPerAxis] [Iterations], i.e. with Content/Debug/TestMap open.
+	 */
+	void BenchmarkPlacementTrace(const TArray<FString>& Args)
+	{
+		FLevelEditorViewportClient* ViewportClient = GCurrentLevelEditingViewportClient;
+		if (ViewportClient == nullptr || ViewportClient->Viewport == nullptr || ViewportClient->GetWorld() == nullptr)
+		{
+			UE_LOG(LogDesigner, Warning, TEXT("BenchmarkPlacementTrace: No active level viewport."));
+			return;
+		}
+
+		const int32 RaysPerAxis = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 16;
+		const int32 Iterations = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 10;
+
+		FSceneViewFamilyContext ViewFamily(FSceneViewFamily::ConstructionValues(
+			ViewportClient->Viewport,
+			ViewportClient->GetScene(),
+			ViewportClient->EngineShowFlags)
+			.SetRealtimeUpdate(ViewportClient->IsRealtime()));
+		FSceneView* View = ViewportClient->CalcSceneView(&ViewFamily);
+
+		TArray<FViewportCursorLocation> Cursors;
+		const FIntPoint ViewportSize = ViewportClient->Viewport->GetSizeXY();
+		for (int32 Y = 0; Y < RaysPerAxis; Y++)
+		{
+			for (int32 X = 0; X < RaysPerAxis; X++)
+			{
+				Cursors.Emplace(View, ViewportClient, (2 * X + 1) * ViewportSize.X / (2 * RaysPerAxis), (2 * Y + 1) * ViewportSize.Y / (2 * RaysPerAxis));
+			}
+		}
+
+		const TArray<AActor*> NoIgnoredActors;
+		int32 ActorPositioningHits = 0;
+		int32 PlacementTraceHits = 0;
+
+		const double ActorPositioningStartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			for (const FViewportCursorLocation& Cursor : Cursors)
+			{
+				ActorPositioningHits += FActorPositioning::TraceWorldForPositionWithDefault(Cursor, *View, &NoIgnoredActors).State == FActorPositionTraceResult::HitSuccess ? 1 : 0;
+			}
+		}
+		const double ActorPositioningTime = FPlatformTime::Seconds() - ActorPositioningStartTime;
+
+		const double PlacementTraceStartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			for (const FViewportCursorLocation& Cursor : Cursors)
+			{
+				PlacementTraceHits += FPlacementTrace::Trace(ViewportClient->GetWorld(), Cursor.GetOrigin(), Cursor.GetDirection(), ECC_Visibility, {}, &ViewportClient->EngineShowFlags).State == FActorPositionTraceResult::HitSuccess ? 1 : 0;
+			}
+		}
+		const double PlacementTraceTime = FPlatformTime::Seconds() - PlacementTraceStartTime;
+
+		const int32 NumTraces = Cursors.Num() * Iterations;
+		UE_LOG(LogDesigner, Log, TEXT("BenchmarkPlacementTrace: %d traces in %s."), NumTraces, *ViewportClient->GetWorld()->GetMapName());
+		UE_LOG(LogDesigner, Log, TEXT("BenchmarkPlacementTrace: FActorPositioning %.3f us per trace, %d hits."), ActorPositioningTime * 1000000.0 / NumTraces, ActorPositioningHits);
+		UE_LOG(LogDesigner, Log, TEXT("BenchmarkPlacementTrace: FPlacementTrace %.3f us per trace, %d hits."), PlacementTraceTime * 1000000.0 / NumTraces, PlacementTraceHits);
+	}
+
+	FAutoConsoleCommand BenchmarkPlacementTraceCommand(
+		TEXT("Designer.BenchmarkPlacementTrace"),
+		TEXT("Compare the Designer placement trace with FActorPositioning in the active level viewport. Args: [RaysPerAxis] [Iterations]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkPlacementTrace));
+}
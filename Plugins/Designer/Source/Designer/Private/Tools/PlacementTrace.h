@@ -0,0 +1,55 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "Editor/UnrealEd/Private/Editor/ActorPositioning.h"
+
+class UWorld;
+struct FEngineShowFlags;
+
+/**
+ * Traces the cursor ray for placement with a single trace which stops at the first valid hit.
+ * Preview actors are not ignored, they are expected to use a collision profile which doesn't respond to the trace.
+ */
+class FPlacementTrace
+{
+public:
+	/** The maximum number of invalid hits, i.e. hidden components, which are skipped before the trace gives up */
+	static constexpr int32 MaxSkippedHits = 8;
+
+	/**
+	 * Trace the ray against the channel, or against the object types when any are given.
+	 * The state of the result is Default when nothing valid was hit, the same as FActorPositioning.
+	 */
+	static FActorPositionTraceResult Trace(const UWorld* World, const FVector& RayOrigin, const FVector& RayDirection, ECollisionChannel TraceChannel, const TArray<TEnumAsByte<EObjectTypeQuery>>& ObjectTypes, const FEngineShowFlags* ShowFlags = nullptr, float MaxDistance = WORLD_MAX);
+
+	/** Returns true if the hit is on something which is visible in the viewport */
+	static bool IsHitValid(const FHitResult& Hit, const FEngineShowFlags* ShowFlags = nullptr);
+
+	/** Convert the hit to a placement trace result */
+	static FActorPositionTraceResult MakeTraceResult(const FHitResult& Hit);
+};
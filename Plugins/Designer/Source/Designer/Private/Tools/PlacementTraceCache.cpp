@@ -0,0 +1,133 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PlacementTraceCache.h"
+#include "DesignerModule.h"
+
+#include "GameFramework/Actor.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Placement Trace Cache Hits"), STAT_DesignerPlacementTraceCacheHits, STATGROUP_Designer);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Placement Trace Cache Misses"), STAT_DesignerPlacementTraceCacheMisses, STATGROUP_Designer);
+
+FPlacementTraceCache::FPlacementTraceCache()
+	: bHasCachedTrace(false)
+	, CachedRayOrigin(FVector::ZeroVector)
+	, CachedRayDirection(FVector::ZeroVector)
+	, WorldChangeCounter(0)
+	, CachedWorldChangeCounter(0)
+	, Tolerance(1.F)
+	, HitCount(0)
+	, MissCount(0)
+{
+
+}
+
+void FPlacementTraceCache::SetTolerance(float NewTolerance)
+{
+	Tolerance = FMath::Max(NewTolerance, 0.F);
+}
+
+bool FPlacementTraceCache::Find(const UWorld* World, const FVector& RayOrigin, const FVector& RayDirection, FActorPositionTraceResult& OutResult)
+{
+	bool bIsReusable = bHasCachedTrace
+		&& CachedWorld.Get() == World
+		&& CachedWorldChangeCounter == WorldChangeCounter
+		&& FVector::DistSquared(CachedRayOrigin, RayOrigin) <= FMath::Square(Tolerance);
+
+	if (bIsReusable)
+	{
+		if (CachedResult.State == FActorPositionTraceResult::Default)
+		{
+			// Nothing was hit, so there is no location to compare against.
+			bIsReusable = CachedRayDirection.Equals(RayDirection, KINDA_SMALL_NUMBER);
+		}
+		else
+		{
+			bIsReusable = (RayDirection | (CachedResult.Location - RayOrigin)) > 0.F
+				&& FMath::PointDistToLine(CachedResult.Location, RayDirection, RayOrigin) <= Tolerance;
+		}
+	}
+
+	if (!bIsReusable)
+	{
+		MissCount++;
+		SET_DWORD_STAT(STAT_DesignerPlacementTraceCacheMisses, MissCount);
+		return false;
+	}
+
+	HitCount++;
+	SET_DWORD_STAT(STAT_DesignerPlacementTraceCacheHits, HitCount);
+
+	OutResult = CachedResult;
+	return true;
+}
+
+void FPlacementTraceCache::Store(const UWorld* World, const FVector& RayOrigin, const FVector& RayDirection, const FActorPositionTraceResult& Result)
+{
+	bHasCachedTrace = true;
+	CachedWorld = World;
+	CachedRayOrigin = RayOrigin;
+	CachedRayDirection = RayDirection;
+	CachedResult = Result;
+	CachedWorldChangeCounter = WorldChangeCounter;
+}
+
+void FPlacementTraceCache::NotifyActorChanged(const AActor* Actor)
+{
+	if (!bHasCachedTrace || Actor == nullptr)
+		return;
+
+	// The hit actor may have moved away from the cached hit location.
+	if (CachedResult.HitActor.Get() == Actor)
+	{
+		Invalidate();
+		return;
+	}
+
+	const FBox ActorBounds = Actor->GetComponentsBoundingBox(true);
+	if (!ActorBounds.IsValid)
+		return;
+
+	const FVector RayEnd = GetCachedRayEnd();
+	if (FMath::LineBoxIntersection(ActorBounds.ExpandBy(Tolerance), CachedRayOrigin, RayEnd, RayEnd - CachedRayOrigin))
+	{
+		Invalidate();
+	}
+}
+
+void FPlacementTraceCache::Invalidate()
+{
+	bHasCachedTrace = false;
+	WorldChangeCounter++;
+}
+
+FVector FPlacementTraceCache::GetCachedRayEnd() const
+{
+	if (CachedResult.State == FActorPositionTraceResult::Default)
+	{
+		return CachedRayOrigin + CachedRayDirection * WORLD_MAX;
+	}
+
+	return CachedResult.Location + CachedRayDirection * Tolerance;
+}
@@ -0,0 +1,87 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Editor/UnrealEd/Private/Editor/ActorPositioning.h"
+
+class AActor;
+class UWorld;
+
+/**
+ * Remembers the last placement trace, so hovering the same pixel or clicking where the cursor just hovered doesn't trace the world again.
+ * The trace is only reused while nothing changed in the world along the traced ray.
+ */
+class FPlacementTraceCache
+{
+private:
+	bool bHasCachedTrace;
+
+	TWeakObjectPtr<const UWorld> CachedWorld;
+
+	FVector CachedRayOrigin;
+
+	FVector CachedRayDirection;
+
+	FActorPositionTraceResult CachedResult;
+
+	/** Incremented whenever an actor is added, moved or removed along the cached ray */
+	uint32 WorldChangeCounter;
+
+	/** The world change counter at the time the trace was cached */
+	uint32 CachedWorldChangeCounter;
+
+	/** The distance in world units the ray may be away from the cached hit location to still reuse it */
+	float Tolerance;
+
+	uint32 HitCount;
+
+	uint32 MissCount;
+
+public:
+	FPlacementTraceCache();
+
+	void SetTolerance(float NewTolerance);
+
+	/** Returns true and the cached result when it can be reused for the ray */
+	bool Find(const UWorld* World, const FVector& RayOrigin, const FVector& RayDirection, FActorPositionTraceResult& OutResult);
+
+	void Store(const UWorld* World, const FVector& RayOrigin, const FVector& RayDirection, const FActorPositionTraceResult& Result);
+
+	/** Invalidates the cached trace if the actor was hit by it or is now in the way of the cached ray */
+	void NotifyActorChanged(const AActor* Actor);
+
+	void Invalidate();
+
+	FORCEINLINE uint32 GetHitCount() const { return HitCount; }
+
+	FORCEINLINE uint32 GetMissCount() const { return MissCount; }
+
+	FORCEINLINE float GetHitRate() const { return HitCount + MissCount > 0 ? (float)HitCount / (float)(HitCount + MissCount) : 0.F; }
+
+private:
+	/** The end of the ray segment along which a changed actor invalidates the cached trace */
+	FVector GetCachedRayEnd() const;
+};
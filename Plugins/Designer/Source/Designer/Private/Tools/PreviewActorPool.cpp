@@ -0,0 +1,256 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PreviewActorPool.h"
+#include "DesignerModule.h"
+
+#include "GameFramework/Actor.h"
+#include "Components/ActorComponent.h"
+#include "UObject/GCObject.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Preview Pool Actors"), STAT_DesignerPreviewPoolActors, STATGROUP_Designer);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Preview Pool Hits"), STAT_DesignerPreviewPoolHits, STATGROUP_Designer);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Preview Pool Misses"), STAT_DesignerPreviewPoolMisses, STATGROUP_Designer);
+DECLARE_MEMORY_STAT(TEXT("Preview Pool Memory"), STAT_DesignerPreviewPoolMemory, STATGROUP_Designer);
+
+FPreviewActorPool::FPreviewActorPool()
+	: ReleaseCounter(0)
+	, TotalSizeBytes(0)
+	, MaxActors(16)
+	, MaxActorsPerAsset(2)
+	, HitCount(0)
+	, MissCount(0)
+{
+
+}
+
+void FPreviewActorPool::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	for (FPooledActor& PooledActor : IdleActors)
+	{
+		Collector.AddReferencedObject(PooledActor.Actor);
+	}
+}
+
+void FPreviewActorPool::SetLimits(int32 InMaxActors, int32 InMaxActorsPerAsset)
+{
+	MaxActors = FMath::Max(InMaxActors, 0);
+	MaxActorsPerAsset = FMath::Max(InMaxActorsPerAsset, 0);
+	EvictToLimits();
+}
+
+AActor* FPreviewActorPool::Acquire(const FAssetData& AssetData)
+{
+	// Use the most recently released actor, the older ones are the first to be evicted.
+	int32 FoundIndex = INDEX_NONE;
+	for (int32 Index = IdleActors.Num() - 1; Index >= 0; --Index)
+	{
+		if (IdleActors[Index].ObjectPath != AssetData.ObjectPath)
+			continue;
+
+		// The actor is gone when the level it was spawned in is unloaded.
+		if (!IsValid(IdleActors[Index].Actor))
+		{
+			TotalSizeBytes -= IdleActors[Index].SizeBytes;
+			IdleActors.RemoveAt(Index);
+
+			// The entries after the removed one moved down by one, including the one already found.
+			if (FoundIndex != INDEX_NONE && FoundIndex > Index)
+			{
+				FoundIndex--;
+			}
+			continue;
+		}
+
+		if (FoundIndex == INDEX_NONE || IdleActors[Index].ReleaseIndex > IdleActors[FoundIndex].ReleaseIndex)
+		{
+			FoundIndex = Index;
+		}
+	}
+
+	if (FoundIndex == INDEX_NONE)
+	{
+		MissCount++;
+		UpdateStats();
+		return nullptr;
+	}
+
+	HitCount++;
+
+	AActor* Actor = IdleActors[FoundIndex].Actor;
+	TotalSizeBytes -= IdleActors[FoundIndex].SizeBytes;
+	IdleActors.RemoveAtSwap(FoundIndex);
+
+	Actor->SetActorEnableCollision(true);
+	Actor->SetIsTemporarilyHiddenInEditor(false);
+	ActiveActors.Add(Actor, AssetData.ObjectPath);
+
+	UpdateStats();
+	return Actor;
+}
+
+void FPreviewActorPool::AddActive(const FAssetData& AssetData, AActor* Actor)
+{
+	if (Actor != nullptr)
+	{
+		ActiveActors.Add(Actor, AssetData.ObjectPath);
+	}
+}
+
+void FPreviewActorPool::Release(AActor* Actor)
+{
+	if (!IsValid(Actor))
+		return;
+
+	FName ObjectPath;
+	if (!ActiveActors.RemoveAndCopyValue(Actor, ObjectPath) || MaxActors == 0 || MaxActorsPerAsset == 0)
+	{
+		// Preview actors are transient, so the level is not modified.
+		Actor->Destroy(false, false);
+		return;
+	}
+
+	// Hidden actors are not rendered and without collision they don't get in the way of the placement traces.
+	Actor->SetIsTemporarilyHiddenInEditor(true);
+	Actor->SetActorEnableCollision(false);
+
+	FPooledActor& PooledActor = IdleActors.AddDefaulted_GetRef();
+	PooledActor.Actor = Actor;
+	PooledActor.ObjectPath = ObjectPath;
+	PooledActor.SizeBytes = CalculateActorSizeBytes(Actor);
+	PooledActor.ReleaseIndex = ++ReleaseCounter;
+
+	TotalSizeBytes += PooledActor.SizeBytes;
+
+	EvictToLimits();
+}
+
+void FPreviewActorPool::Trim(TFunctionRef<bool(const FName& ObjectPath)> ShouldKeep)
+{
+	for (int32 Index = IdleActors.Num() - 1; Index >= 0; --Index)
+	{
+		if (!ShouldKeep(IdleActors[Index].ObjectPath))
+		{
+			DestroyIdleActor(Index);
+		}
+	}
+
+	UpdateStats();
+}
+
+void FPreviewActorPool::Empty()
+{
+	for (int32 Index = IdleActors.Num() - 1; Index >= 0; --Index)
+	{
+		DestroyIdleActor(Index);
+	}
+
+	ActiveActors.Empty();
+	TotalSizeBytes = 0;
+	UpdateStats();
+}
+
+void FPreviewActorPool::ResetCounters()
+{
+	HitCount = 0;
+	MissCount = 0;
+	UpdateStats();
+}
+
+void FPreviewActorPool::EvictToLimits()
+{
+	// The pool only holds a handful of actors, so linear searches are cheap.
+	while (IdleActors.Num() > 0)
+	{
+		int32 EvictIndex = INDEX_NONE;
+		if (IdleActors.Num() > MaxActors)
+		{
+			EvictIndex = 0;
+			for (int32 Index = 1; Index < IdleActors.Num(); ++Index)
+			{
+				if (IdleActors[Index].ReleaseIndex < IdleActors[EvictIndex].ReleaseIndex)
+				{
+					EvictIndex = Index;
+				}
+			}
+		}
+		else
+		{
+			// Only the most recently released asset can exceed its limit, all other assets were within their limit before.
+			const FPooledActor& LastReleased = IdleActors.Last();
+			int32 AssetActorCount = 0;
+			for (int32 Index = 0; Index < IdleActors.Num(); ++Index)
+			{
+				if (IdleActors[Index].ObjectPath == LastReleased.ObjectPath)
+				{
+					AssetActorCount++;
+					if (EvictIndex == INDEX_NONE || IdleActors[Index].ReleaseIndex < IdleActors[EvictIndex].ReleaseIndex)
+					{
+						EvictIndex = Index;
+					}
+				}
+			}
+
+			if (AssetActorCount <= MaxActorsPerAsset)
+				break;
+		}
+
+		DestroyIdleActor(EvictIndex);
+	}
+
+	UpdateStats();
+}
+
+void FPreviewActorPool::DestroyIdleActor(int32 Index)
+{
+	FPooledActor& PooledActor = IdleActors[Index];
+	if (IsValid(PooledActor.Actor))
+	{
+		PooledActor.Actor->Destroy(false, false);
+	}
+
+	TotalSizeBytes -= PooledActor.SizeBytes;
+	IdleActors.RemoveAt(Index);
+}
+
+int64 FPreviewActorPool::CalculateActorSizeBytes(AActor* Actor)
+{
+	int64 SizeBytes = Actor->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+
+	TInlineComponentArray<UActorComponent*> Components(Actor);
+	for (UActorComponent* Component : Components)
+	{
+		SizeBytes += Component->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+	}
+
+	return SizeBytes;
+}
+
+void FPreviewActorPool::UpdateStats() const
+{
+	SET_DWORD_STAT(STAT_DesignerPreviewPoolActors, IdleActors.Num());
+	SET_DWORD_STAT(STAT_DesignerPreviewPoolHits, HitCount);
+	SET_DWORD_STAT(STAT_DesignerPreviewPoolMisses, MissCount);
+	SET_MEMORY_STAT(STAT_DesignerPreviewPoolMemory, TotalSizeBytes);
+}
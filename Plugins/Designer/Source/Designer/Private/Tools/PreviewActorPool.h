@@ -0,0 +1,118 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+
+class AActor;
+class FReferenceCollector;
+
+/**
+ * Keeps preview actors which are no longer shown hidden in the level, so showing the preview of the same asset again does not spawn a new actor.
+ * The least recently released actors are destroyed when the actor count exceeds the limits.
+ */
+class FPreviewActorPool
+{
+private:
+	struct FPooledActor
+	{
+		AActor* Actor = nullptr;
+
+		FName ObjectPath;
+
+		/** The estimated memory used by the actor and its components */
+		int64 SizeBytes = 0;
+
+		/** The release counter value when this actor was released, the lowest value is the least recently released */
+		uint64 ReleaseIndex = 0;
+	};
+
+	/** The hidden actors which are ready to be used again */
+	TArray<FPooledActor> IdleActors;
+
+	/** The asset object path of every shown preview actor, so the actor can be pooled when it is released */
+	TMap<AActor*, FName> ActiveActors;
+
+	/** Increased every time an actor is released */
+	uint64 ReleaseCounter;
+
+	/** The total estimated memory used by all idle actors */
+	int64 TotalSizeBytes;
+
+	int32 MaxActors;
+
+	int32 MaxActorsPerAsset;
+
+	uint32 HitCount;
+
+	uint32 MissCount;
+
+public:
+	FPreviewActorPool();
+
+	/** Keep the idle actors from being garbage collected */
+	void AddReferencedObjects(FReferenceCollector& Collector);
+
+	/** Change the limits of the pool, destroying idle actors which don't fit anymore */
+	void SetLimits(int32 InMaxActors, int32 InMaxActorsPerAsset);
+
+	/** Returns a shown idle actor of the asset, or null if there is none. Counts as a hit or a miss. */
+	AActor* Acquire(const FAssetData& AssetData);
+
+	/** Track a newly spawned preview actor of the asset, so it is pooled when released */
+	void AddActive(const FAssetData& AssetData, AActor* Actor);
+
+	/** Hide the actor and keep it for later use. Actors which are not tracked or don't fit are destroyed. */
+	void Release(AActor* Actor);
+
+	/** Destroy the idle actors of the assets which should not be kept */
+	void Trim(TFunctionRef<bool(const FName& ObjectPath)> ShouldKeep);
+
+	/** Destroy all idle actors and stop tracking the shown actors, the counters are kept */
+	void Empty();
+
+	FORCEINLINE int32 Num() const { return IdleActors.Num(); }
+
+	FORCEINLINE int64 GetTotalSizeBytes() const { return TotalSizeBytes; }
+
+	FORCEINLINE uint32 GetHitCount() const { return HitCount; }
+
+	FORCEINLINE uint32 GetMissCount() const { return MissCount; }
+
+	/** Reset the hit and miss counters */
+	void ResetCounters();
+
+private:
+	/** Destroy the least recently released actors until the pool fits within its limits */
+	void EvictToLimits();
+
+	/** Destroy the idle actor at the index */
+	void DestroyIdleActor(int32 Index);
+
+	static int64 CalculateActorSizeBytes(AActor* Actor);
+
+	void UpdateStats() const;
+};
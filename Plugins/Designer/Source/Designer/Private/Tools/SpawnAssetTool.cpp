@@ -28,8 +28,11 @@
 #include "UObject/Class.h"
 #include "GameFramework/Actor.h"
 #include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "Engine/CollisionProfile.h"
+#include "Engine/StreamableManager.h"
+#include "SceneManagement.h"
 
 #include "Editor/EditorEngine.h"
 #include "Engine/Selection.h"
@@ -38,22 +41,40 @@
 #include "SnappingUtils.h"
 #include "Editor/UnrealEd/Private/Editor/ActorPositioning.h"
 #include "Editor/UnrealEd/Classes/ActorFactories/ActorFactory.h"
+#include "Editor/UnrealEd/Classes/ActorFactories/ActorFactoryStaticMesh.h"
+#include "Editor/UnrealEd/Classes/ActorFactories/ActorFactoryBlueprint.h"
+#include "Engine/Blueprint.h"
+#include "Tools/AssetBoundsUtils.h"
 #include "Runtime/Engine/Public/LevelUtils.h"
 #include "Runtime/Core/Public/Internationalization/Internationalization.h"
 
 #include "DesignerSettings.h"
+#include "DesignerPalette.h"
+#include "AssetRegistry/AssetRegistryModule.h"
 
 #include "Editor.h"
 #include "Logging/MessageLog.h"
+#include "HAL/IConsoleManager.h"
+#include "Components/SceneComponent.h"
 
 #define LOCTEXT_NAMESPACE "FDesignerEditorMode"
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Coalesced Mouse Moves"), STAT_DesignerCoalescedMouseMoves, STATGROUP_Designer);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Dropped Async Traces"), STAT_DesignerDroppedAsyncTraces, STATGROUP_Designer);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Viewport Invalidations"), STAT_DesignerViewportInvalidations, STATGROUP_Designer);
+
 FSpawnAssetTool::FSpawnAssetTool(UDesignerSettings* DesignerSettings)
+	: PlaceableSelectedAssets(PlaceableAssetIndex)
 {
 	this->DesignerSettings = DesignerSettings;
 
 	UStaticMesh* PlaneStaticMesh = nullptr;
 
+	CursorInputDownWorldLocationParameterIndex = INDEX_NONE;
+	CursorPlaneWorldLocationParameterIndex = INDEX_NONE;
+	ForwardAxisColorParameterIndex = INDEX_NONE;
+	SpawnVisualizerForwardAxisColor = FLinearColor::Transparent;
+
 	if (!IsRunningCommandlet())
 	{
 		UMaterialInterface* SpawnVisualizerMaterial = LoadObject<UMaterialInterface>(GetDesignerSettings(), TEXT("/Designer/MI_SpawnVisualizer.MI_SpawnVisualizer"), nullptr, LOAD_None, nullptr);
@@ -62,6 +83,10 @@ FSpawnAssetTool::FSpawnAssetTool(UDesignerSettings* DesignerSettings)
 		SpawnVisualizerMID = UMaterialInstanceDynamic::Create(SpawnVisualizerMaterial, GetDesignerSettings());
 		check(SpawnVisualizerMID != nullptr);
 
+		SpawnVisualizerMID->InitializeVectorParameterAndGetIndex(TEXT("CursorInputDownWorldLocation"), FLinearColor::Black, CursorInputDownWorldLocationParameterIndex);
+		SpawnVisualizerMID->InitializeVectorParameterAndGetIndex(TEXT("CursorPlaneWorldLocation"), FLinearColor::Black, CursorPlaneWorldLocationParameterIndex);
+		SpawnVisualizerMID->InitializeVectorParameterAndGetIndex(TEXT("ForwardAxisColor"), SpawnVisualizerForwardAxisColor, ForwardAxisColorParameterIndex);
+
 		PlaneStaticMesh = LoadObject<UStaticMesh>(GetDesignerSettings(), TEXT("/Designer/SM_SpawnVisualizer.SM_SpawnVisualizer"), nullptr, LOAD_None, nullptr);
 		check(PlaneStaticMesh != nullptr);
 
@@ -80,10 +105,52 @@ FSpawnAssetTool::FSpawnAssetTool(UDesignerSettings* DesignerSettings)
 	 SpawnPlaneComponent->SetAbsolute(true, true, true);
 	 SpawnPlaneComponent->CastShadow = false;
 
+	SpawnPlaneMeshSize = PlaneStaticMesh != nullptr ? PlaneStaticMesh->GetBoundingBox().GetSize().GetAbsMax() : 0.F;
+	SpawnPlaneCoveredRadius = 0.F;
+
+	MeshPreviewComponent = NewObject<UStaticMeshComponent>(GetTransientPackage(), TEXT("DesignerMeshPreviewComponent"));
+	MeshPreviewComponent->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+	MeshPreviewComponent->SetMobility(EComponentMobility::Movable);
+	MeshPreviewComponent->SetAbsolute(true, true, true);
+	MeshPreviewComponent->CastShadow = false;
+	MeshPreviewComponent->bSelectable = false;
+
 	ControlledSpawnedActor = nullptr;
 	ReleasedSpawnedActor = nullptr;
+	bIsSpawningPreviewActor = false;
+	bIsControlledActorSuspended = false;
+	bControlledActorEnableCollision = true;
 
 	ActorScrollWheelOffset = 0;
+
+	bHasPendingSpawn = false;
+	bIsPendingSpawnReleased = false;
+	PendingSpawnViewportClient = nullptr;
+	PendingMouseMoveViewportClient = nullptr;
+	bIsPendingMouseMoveCaptured = false;
+	CoalescedMouseMoveCount = 0;
+	CursorViewportClient = nullptr;
+	ViewportInvalidationCount = 0;
+	AsyncTraceViewportClient = nullptr;
+	AsyncTraceFrameCounter = 0;
+	AsyncTraceOrigin = FVector::ZeroVector;
+	AsyncTraceDirection = FVector::ZeroVector;
+	DroppedAsyncTraceCount = 0;
+	LandscapeHeightfieldHitCount = 0;
+	LandscapeHeightfieldFallbackCount = 0;
+	LastEstimatedNormalLocation = FVector::ZeroVector;
+	LastEstimatedNormalSurfaceNormal = FVector::ZeroVector;
+	LastEstimatedNormal = FVector::UpVector;
+	SurfaceNormalTraceFrameCounter = 0;
+	ProvisionalEstimatedNormal = FVector::UpVector;
+
+	LoadedTargetAsset = nullptr;
+	TargetActorFactory = nullptr;
+	TargetPaletteEntryIndex = INDEX_NONE;
+	LastPrewarmFrameCounter = 0;
+
+	PaletteEntrySettings = NewObject<UDesignerSettings>(GetTransientPackage(), NAME_None, RF_Transient);
+	SpawnSettings = DesignerSettings;
 }
 
 FSpawnAssetTool::~FSpawnAssetTool()
@@ -95,6 +162,16 @@ void FSpawnAssetTool::AddReferencedObjects(FReferenceCollector& Collector)
 {
 	Collector.AddReferencedObject(DesignerSettings);
 	Collector.AddReferencedObject(SpawnPlaneComponent);
+	Collector.AddReferencedObject(MeshPreviewComponent);
+	Collector.AddReferencedObject(LoadedTargetAsset);
+	Collector.AddReferencedObject(TargetActorFactory);
+	Collector.AddReferencedObject(PaletteEntrySettings);
+	Collector.AddReferencedObject(PrewarmedTarget.Asset);
+	Collector.AddReferencedObject(PrewarmedTarget.ActorFactory);
+	Collector.AddReferencedObject(PrewarmedTarget.PreviewActor);
+	ResidencyCache.AddReferencedObjects(Collector);
+	PreviewActorPool.AddReferencedObjects(Collector);
+	BlueprintPreviews.AddReferencedObjects(Collector);
 }
 
 FString FSpawnAssetTool::GetName() const
@@ -106,6 +183,27 @@ void FSpawnAssetTool::EnterTool()
 {
 	UE_LOG(LogDesigner, Log, TEXT("SpawnAssetTool::EnterTool"));
 
+	ExtentCache.Load();
+
+	PlaceableAssetIndex.Initialize();
+	PlaceableSelectedAssets.GetOnSelectionChanged().AddRaw(this, &FSpawnAssetTool::OnPlaceableSelectionChanged);
+	PlaceableSelectedAssets.Initialize();
+
+	if (GEngine != nullptr)
+	{
+		GEngine->OnLevelActorAdded().AddRaw(this, &FSpawnAssetTool::OnLevelActorChanged);
+		GEngine->OnLevelActorDeleted().AddRaw(this, &FSpawnAssetTool::OnLevelActorChanged);
+		GEngine->OnActorMoved().AddRaw(this, &FSpawnAssetTool::OnLevelActorChanged);
+	}
+
+	if (GEditor != nullptr)
+	{
+		GEditor->OnBlueprintCompiled().AddRaw(this, &FSpawnAssetTool::OnBlueprintCompiled);
+	}
+
+	FEditorDelegates::PostUndoRedo.AddRaw(this, &FSpawnAssetTool::OnUndoRedo);
+	FCoreUObjectDelegates::OnObjectsReplaced.AddRaw(this, &FSpawnAssetTool::OnObjectsReplaced);
+
 	SetToolActive(false);
 }
 
@@ -114,6 +212,62 @@ void FSpawnAssetTool::ExitTool()
 	UE_LOG(LogDesigner, Log, TEXT("SpawnAssetTool::ExitTool"));
 
 	SetToolActive(false);
+
+	UE_LOG(LogDesigner, Log, TEXT("SpawnAssetTool: Coalesced %u mouse moves, dropped %u async traces."), CoalescedMouseMoveCount, DroppedAsyncTraceCount);
+	CoalescedMouseMoveCount = 0;
+	DroppedAsyncTraceCount = 0;
+
+	UE_LOG(LogDesigner, Log, TEXT("SpawnAssetTool: Invalidated the viewport %u times."), ViewportInvalidationCount);
+	ViewportInvalidationCount = 0;
+	CursorViewportClient = nullptr;
+	LastViewportRedrawState = FViewportRedrawState();
+
+	UE_LOG(LogDesigner, Log, TEXT("SpawnAssetTool: Residency cache hits %u, misses %u, %d assets using %lld bytes."), ResidencyCache.GetHitCount(), ResidencyCache.GetMissCount(), ResidencyCache.Num(), ResidencyCache.GetTotalSizeBytes());
+	ResidencyCache.Empty();
+
+	UE_LOG(LogDesigner, Log, TEXT("SpawnAssetTool: Preview actor pool hits %u, misses %u, %d actors using %lld bytes."), PreviewActorPool.GetHitCount(), PreviewActorPool.GetMissCount(), PreviewActorPool.Num(), PreviewActorPool.GetTotalSizeBytes());
+	PreviewActorPool.Empty();
+
+	UE_LOG(LogDesigner, Log, TEXT("SpawnAssetTool: Viewport view cache hits %u, misses %u."), ViewportViews.GetHitCount(), ViewportViews.GetMissCount());
+	ViewportViews.Empty();
+
+	UE_LOG(LogDesigner, Log, TEXT("SpawnAssetTool: Placement trace cache hits %u, misses %u, hit rate %.2f."), PlacementTraces.GetHitCount(), PlacementTraces.GetMissCount(), PlacementTraces.GetHitRate());
+	PlacementTraces.Invalidate();
+
+	StaticGeometry.Empty();
+
+	UE_LOG(LogDesigner, Log, TEXT("SpawnAssetTool: Landscape heightfield hits %u, fallbacks %u, %d tiles."), LandscapeHeightfieldHitCount, LandscapeHeightfieldFallbackCount, LandscapeHeightfields.NumTiles());
+	LandscapeHeightfields.Empty();
+	LandscapeHeightfieldHitCount = 0;
+	LandscapeHeightfieldFallbackCount = 0;
+
+	CancelSurfaceNormalTraces();
+
+	if (GEngine != nullptr)
+	{
+		GEngine->OnLevelActorAdded().RemoveAll(this);
+		GEngine->OnLevelActorDeleted().RemoveAll(this);
+		GEngine->OnActorMoved().RemoveAll(this);
+	}
+
+	if (GEditor != nullptr)
+	{
+		GEditor->OnBlueprintCompiled().RemoveAll(this);
+	}
+
+	FEditorDelegates::PostUndoRedo.RemoveAll(this);
+	FCoreUObjectDelegates::OnObjectsReplaced.RemoveAll(this);
+
+	UE_LOG(LogDesigner, Log, TEXT("SpawnAssetTool: Blueprint preview hits %u, misses %u, %d classes."), BlueprintPreviews.GetHitCount(), BlueprintPreviews.GetMissCount(), BlueprintPreviews.Num());
+	BlueprintPreviews.Empty();
+	MaterialSlotLayouts.Empty();
+
+	PlaceableSelectedAssets.Shutdown();
+	PlaceableSelectedAssets.GetOnSelectionChanged().RemoveAll(this);
+	PlaceableAssetIndex.Shutdown();
+
+	ExtentCache.CancelPrefetch();
+	ExtentCache.Save();
 }
 
 bool FSpawnAssetTool::IsSelectionAllowed(AActor* InActor, bool bInSelection) const
@@ -139,17 +293,7 @@ bool FSpawnAssetTool::MouseMove(FEditorViewportClient* ViewportClient, FViewport
 {
 	if (bIsToolActive && !IsValid(ControlledSpawnedActor))
 	{
-		if (PreviewActorArray.Num() == 0)
-		{
-			RefreshPreviewActors();
-		}
-
-		RecalculateSpawnTransform(ViewportClient, Viewport);
-
-		// Update the cursor plane world location to be the same as the spawn location so the rotation calculation is done properly.
-		CursorPlaneIntersectionWorldLocation = SpawnWorldTransform.GetLocation();
-
-		UpdatePreviewActorTransform();
+		QueueMouseMove(ViewportClient, false);
 	}
 
 	return bIsToolActive;
@@ -175,9 +319,7 @@ bool FSpawnAssetTool::CapturedMouseMove(FEditorViewportClient* ViewportClient, F
 
 	if (IsValid(ControlledSpawnedActor))
 	{
-		RecalculateMousePlaneIntersectionWorldLocation(ViewportClient, Viewport);
-		UpdateSpawnedActorTransform();
-		UpdateSpawnVisualizerMaterialParameters();
+		QueueMouseMove(ViewportClient, true);
 
 		bHandled = true;
 	}
@@ -208,13 +350,15 @@ bool FSpawnAssetTool::InputKey(FEditorViewportClient* ViewportClient, FViewport*
 
 	bool bHandled = false;
 
+	// Only the viewport which receives the input is redrawn for the tool.
+	CursorViewportClient = ViewportClient;
+
 	if (Key == EKeys::LeftControl || Key == EKeys::RightControl)
 	{
 		if (Event == IE_Pressed && !bIsToolActive)
 		{
-			ViewportClient->AddRealtimeOverride(true, FText::FromString("Designer_SpawnAssetTool"));
-
 			SetToolActive(true);
+			ClearPendingMouseMove();
 
 			RefreshPlaceableAsset();
 
@@ -230,9 +374,7 @@ bool FSpawnAssetTool::InputKey(FEditorViewportClient* ViewportClient, FViewport*
 		{
 			bHandled = true;
 
-			ViewportClient->RemoveRealtimeOverride(FText::FromString("Designer_SpawnAssetTool"));
-			GEditor->RedrawAllViewports(false);
-
+			// Hiding the previews changes the redraw state, so the viewport is redrawn once on the next tick.
 			SetToolActive(false);
 		}
 	}
@@ -266,42 +408,26 @@ bool FSpawnAssetTool::InputKey(FEditorViewportClient* ViewportClient, FViewport*
 		UE_LOG(LogDesigner, Log, TEXT("SpawnAssetTool::InputKey: Spawn selected asset."));
 		bHandled = true;
 
-		if (TargetAssetDataToSpawn.GetAsset() != nullptr)
-		{
-			UActorFactory* ActorFactory = FActorFactoryAssetProxy::GetFactoryForAssetObject(TargetAssetDataToSpawn.GetAsset());
-			if (ActorFactory)
-			{
-				// Recalculate mouse down, if it fails, return.
-				if (!RecalculateSpawnTransform(ViewportClient, Viewport))
-					return bHandled;
-
-				DestroyPreviewActors();
-
-				ControlledSpawnedActor = GEditor->UseActorFactory(ActorFactory, TargetAssetDataToSpawn, &SpawnWorldTransform);
-				if (ControlledSpawnedActor)
-					SpawnedActorScale = ControlledSpawnedActor->GetActorScale3D();
-				
-				// Properly reset data.
-				CursorPlaneIntersectionWorldLocation = SpawnWorldTransform.GetLocation();
-				SpawnTracePlane = FPlane();
-
-				if (IsValid(SpawnPlaneComponent))
-				{
-					FTransform SpawnVisualizerTransform = SpawnWorldTransform;
-					SpawnVisualizerTransform.SetScale3D(FVector(10000));
-					SpawnPlaneComponent->SetRelativeTransform(SpawnVisualizerTransform);
-				}
+		// The click traces the cursor itself, synchronously so it is exact.
+		ClearPendingMouseMove();
+		CancelAsyncSpawnTrace();
 
-				RegisterSpawnPlane(ViewportClient);
-				UpdateSpawnedActorTransform();
-				UpdateSpawnVisualizerMaterialParameters();
+		if (IsTargetAssetReady())
+		{
+			// Recalculate mouse down, if it fails, return.
+			if (!RecalculateSpawnTransform(ViewportClient, Viewport))
+				return bHandled;
 
-				bHandled = true;
-			}
-			else
-			{
-				UE_LOG(LogDesigner, Log, TEXT("SpawnAssetTool: No actor factory for object"));
-			}
+			SpawnControlledActor(ViewportClient);
+		}
+		else if (TargetAssetDataToSpawn.IsValid() && RecalculateSpawnTransform(ViewportClient, Viewport))
+		{
+			// Never block on the load, spawn at the clicked location as soon as the asset is streamed in.
+			UE_LOG(LogDesigner, Log, TEXT("SpawnAssetTool: Target asset is still loading, queue spawn."));
+			bHasPendingSpawn = true;
+			bIsPendingSpawnReleased = false;
+			PendingSpawnWorldTransform = SpawnWorldTransform;
+			PendingSpawnViewportClient = ViewportClient;
 		}
 	}
 
@@ -310,16 +436,17 @@ bool FSpawnAssetTool::InputKey(FEditorViewportClient* ViewportClient, FViewport*
 	{
 		bHandled = true;
 
-		// Regenerate random data for next actor but only if the current actor has actually been spawned.
-		if (IsValid(ControlledSpawnedActor))
+		if (bHasPendingSpawn)
 		{
-			RefreshPlaceableAsset();
+			// The actor is placed as soon as it is spawned.
+			bIsPendingSpawnReleased = true;
+		}
+		else
+		{
+			// Place the actor where the cursor was released, not where it was at the last tick.
+			FlushPendingMouseMove();
+			CompletePlacement();
 		}
-
-		DestroyPreviewActors();
-		UnregisterSpawnPlane();
-
-		ReleaseControlledActor();
 	}
 
 	if (Key == EKeys::MouseScrollUp && Event == IE_Pressed && bIsToolActive)
@@ -370,13 +497,67 @@ bool FSpawnAssetTool::FrustumSelect(const FConvexVolume& InFrustum, FEditorViewp
 	return false;
 }
 
+void FSpawnAssetTool::Tick(FEditorViewportClient* ViewportClient, float DeltaTime)
+{
+	ClearClosedViewportClients();
+
+	if (bIsToolActive)
+	{
+		// Every viewport ticks, the mouse move is applied by the viewport which received it.
+		if (ViewportClient == PendingMouseMoveViewportClient)
+		{
+			FlushPendingMouseMove();
+		}
+
+		TickAsyncSpawnTrace(ViewportClient);
+		TickSurfaceNormalTraces();
+		TickPrewarm();
+	}
+
+	// Only the actors which changed since the last tick are gathered again.
+	StaticGeometry.Update();
+
+	if (ViewportClient == CursorViewportClient)
+	{
+		InvalidateViewportIfChanged(ViewportClient);
+	}
+}
+
+void FSpawnAssetTool::Render(const FSceneView* View, FViewport* Viewport, FPrimitiveDrawInterface* PDI)
+{
+	// Draw a lightweight proxy of the asset bounds until the real preview can be spawned.
+	if (bIsToolActive && !IsValid(ControlledSpawnedActor) && TargetAssetDataToSpawn.IsValid() && !IsTargetAssetReady())
+	{
+		const FVector Extent = DefaultSpawnedActorExtent * PreviewWorldTransform.GetScale3D().GetAbs();
+		const FQuat Rotation = PreviewWorldTransform.GetRotation();
+		DrawOrientedWireBox(PDI, PreviewWorldTransform.GetLocation(), Rotation.GetForwardVector(), Rotation.GetRightVector(), Rotation.GetUpVector(), Extent, FLinearColor::White, SDPG_World);
+	}
+}
+
 void FSpawnAssetTool::SetToolActive(bool NewIsActive)
 {
 	if (NewIsActive && !bIsToolActive)
 	{
 		UE_LOG(LogDesigner, Log, TEXT("SpawnAssetTool: Setting tool active"));
+		ResidencyCache.SetLimits(DesignerSettings->ResidencyCacheMaxAssets, (int64)DesignerSettings->ResidencyCacheBudgetMB * 1024 * 1024);
+		PreviewActorPool.SetLimits(DesignerSettings->PreviewPoolMaxActors, DesignerSettings->PreviewPoolMaxActorsPerAsset);
+		PlacementTraces.SetTolerance(DesignerSettings->PlacementTraceCacheTolerance);
+
+		if (!DesignerSettings->bBuildStaticGeometryBVH)
+		{
+			StaticGeometry.Empty();
+		}
+		else if (!StaticGeometry.IsBuiltFrom(GWorld, GWorld->GetCurrentLevel(), DesignerSettings->StaticGeometryRegion))
+		{
+			StaticGeometry.Build(GWorld, GWorld->GetCurrentLevel(), DesignerSettings->StaticGeometryRegion);
+		}
 		RefreshPreviewActors();
 
+		if (DesignerSettings->bPrefetchAssetExtents)
+		{
+			ExtentCache.Prefetch(PlaceableSelectedAssets.GetAssets(), DesignerSettings->ResidencyCacheMaxAssets);
+		}
+
 		PreviousSelection.Empty();
 
 		if (GEditor != nullptr)
@@ -398,6 +579,14 @@ void FSpawnAssetTool::SetToolActive(bool NewIsActive)
 	else if (!NewIsActive && bIsToolActive)
 	{
 		UE_LOG(LogDesigner, Log, TEXT("SpawnAssetTool: Setting tool inactive."));
+		ClearPendingSpawn();
+		ClearPendingMouseMove();
+		CancelAsyncSpawnTrace();
+		ExtentCache.CancelPrefetch();
+		ViewportViews.Empty();
+		// Actors can be changed without notifying the listeners while the tool is inactive, i.e. while simulating.
+		PlacementTraces.Invalidate();
+		CancelPrewarm();
 		DestroyPreviewActors();		
 		UnregisterSpawnPlane();
 		ReleaseControlledActor();
@@ -433,17 +622,27 @@ void FSpawnAssetTool::SetToolActive(bool NewIsActive)
 	}
 }
 
-void FSpawnAssetTool::SetAllMaterialsForActor(AActor* Actor, UMaterialInterface* Material)
+void FSpawnAssetTool::SetAllMaterialsForActor(AActor* Actor, const FAssetData& AssetData, UMaterialInterface* Material)
 {
 	if (Actor != nullptr && Material != nullptr)
 	{
-		TArray<UPrimitiveComponent*> PrimitiveComponentArray;
-		Actor->GetComponents<UPrimitiveComponent>(PrimitiveComponentArray, true);
-		for (UPrimitiveComponent* PrimitiveComponent : PrimitiveComponentArray)
+		TInlineComponentArray<UPrimitiveComponent*> PrimitiveComponents(Actor, true);
+		const TArray<int32>& MaterialSlotLayout = GetMaterialSlotLayout(AssetData, PrimitiveComponents);
+
+		for (int32 ComponentIndex = 0; ComponentIndex < PrimitiveComponents.Num(); ComponentIndex++)
 		{
-			if (PrimitiveComponent != nullptr)
+			UPrimitiveComponent* PrimitiveComponent = PrimitiveComponents[ComponentIndex];
+			const int32 MaterialCount = MaterialSlotLayout[ComponentIndex];
+
+			if (UMeshComponent* MeshComponent = Cast<UMeshComponent>(PrimitiveComponent))
+			{
+				// SetMaterial updates the physical materials and dirties the render state for every slot, so all slots are replaced in a single pass instead.
+				// The replaced materials are the materials of the asset or the component template, which stay referenced while the render thread uses them.
+				MeshComponent->OverrideMaterials.Init(Material, MaterialCount);
+				MeshComponent->MarkRenderStateDirty();
+			}
+			else if (PrimitiveComponent != nullptr)
 			{
-				const int32 MaterialCount = PrimitiveComponent->GetNumMaterials();
 				for (int32 MaterialIndex = 0; MaterialIndex < MaterialCount; MaterialIndex++)
 				{
 					PrimitiveComponent->SetMaterial(MaterialIndex, Material);
@@ -453,19 +652,42 @@ void FSpawnAssetTool::SetAllMaterialsForActor(AActor* Actor, UMaterialInterface*
 	}
 }
 
+const TArray<int32>& FSpawnAssetTool::GetMaterialSlotLayout(const FAssetData& AssetData, TArrayView<UPrimitiveComponent*> PrimitiveComponents)
+{
+	// Construction scripts can add a varying number of components, in which case the layout is gathered again.
+	TArray<int32>* MaterialSlotLayout = MaterialSlotLayouts.Find(AssetData.ObjectPath);
+	if (MaterialSlotLayout == nullptr || MaterialSlotLayout->Num() != PrimitiveComponents.Num())
+	{
+		MaterialSlotLayout = &MaterialSlotLayouts.Add(AssetData.ObjectPath);
+		MaterialSlotLayout->Reset(PrimitiveComponents.Num());
+		for (UPrimitiveComponent* PrimitiveComponent : PrimitiveComponents)
+		{
+			MaterialSlotLayout->Add(PrimitiveComponent != nullptr ? PrimitiveComponent->GetNumMaterials() : 0);
+		}
+	}
+
+	return *MaterialSlotLayout;
+}
+
 void FSpawnAssetTool::RefreshPreviewActors()
 {
 	DestroyPreviewActors();
+
+	// The bounds proxy is shown until the asset is streamed in.
+	if (!IsTargetAssetReady())
+		return;
 	
-	UActorFactory* ActorFactory = FActorFactoryAssetProxy::GetFactoryForAssetObject(TargetAssetDataToSpawn.GetAsset());
-	if (TargetAssetDataToSpawn.GetClass() != nullptr)
+	// Static meshes and blueprints with mesh components don't need an actor, components owned by the tool render the preview.
+	if (ShowComponentPreview(LoadedTargetAsset, TargetActorFactory))
+		return;
+
+	UActorFactory* ActorFactory = TargetActorFactory;
+	if (ActorFactory != nullptr)
 	{
-		PreviewActor = SpawnPreviewActorFromFactory(ActorFactory, TargetAssetDataToSpawn, &SpawnWorldTransform, RF_Transient);
+		PreviewActor = AcquirePreviewActor(ActorFactory, TargetAssetDataToSpawn);
 		if (IsValid(PreviewActor) && PreviewActor->IsValidLowLevel())
 		{
 			PreviewActorArray.Add(PreviewActor);
-			PreviewActor->SetActorLabel("DesignerPreviewActor");
-			SetAllMaterialsForActor(PreviewActor, PreviewActorMaterial);
 		}
 
 		// TODO UE5: Currently the pusling is done in a material so does not work with nanaite and translucensy does not work with nanite either. 
@@ -477,7 +699,7 @@ void FSpawnAssetTool::RefreshPreviewActors()
 		//	{
 		//		PreviewActorArray.Add(PreviewActorPulsing);
 		//		PreviewActorPulsing->SetActorLabel("DesignerPreviewActorPulsing");
-		//		SetAllMaterialsForActor(PreviewActorPulsing, PreviewActorPulsingMaterial);
+		//		SetAllMaterialsForActor(PreviewActorPulsing, TargetAssetDataToSpawn, PreviewActorPulsingMaterial);
 		//		PreviewActorPulsing->SetActorScale3D(FVector(DesignerSettings->MinimalScale));
 		//	}
 		//}
@@ -488,15 +710,122 @@ void FSpawnAssetTool::DestroyPreviewActors()
 {
 	for (AActor* Actor : PreviewActorArray)
 	{
-		if (IsValid(Actor))
-		{
-			Actor->Destroy(false, true);
-		}
+		// Pooled actors are hidden, the others are destroyed.
+		PreviewActorPool.Release(Actor);
 	}
 
 	PreviewActorArray.Empty();
 	PreviewActor = nullptr;
 	PreviewActorPulsing = nullptr;
+
+	HideMeshPreview();
+	BlueprintPreviews.Hide();
+}
+
+UStaticMesh* FSpawnAssetTool::GetPreviewStaticMesh(UObject* Asset, UActorFactory* ActorFactory) const
+{
+	// Other factories might add components or change the actor, so only the plain static mesh factory can be previewed without an actor.
+	if (!DesignerSettings->bUseMeshPreviewComponent || ActorFactory == nullptr || !ActorFactory->IsA<UActorFactoryStaticMesh>())
+		return nullptr;
+
+	return Cast<UStaticMesh>(Asset);
+}
+
+const UClass* FSpawnAssetTool::GetPreviewBlueprintClass(UObject* Asset, UActorFactory* ActorFactory) const
+{
+	if (!DesignerSettings->bUseBlueprintTemplatePreview || ActorFactory == nullptr || !ActorFactory->IsA<UActorFactoryBlueprint>())
+		return nullptr;
+
+	const UBlueprint* Blueprint = Cast<UBlueprint>(Asset);
+	return Blueprint != nullptr ? Blueprint->GeneratedClass : nullptr;
+}
+
+bool FSpawnAssetTool::PrepareComponentPreview(UObject* Asset, UActorFactory* ActorFactory)
+{
+	if (GetPreviewStaticMesh(Asset, ActorFactory) != nullptr)
+		return true;
+
+	const UClass* BlueprintClass = GetPreviewBlueprintClass(Asset, ActorFactory);
+	return BlueprintClass != nullptr && BlueprintPreviews.Prepare(BlueprintClass, PreviewActorMaterial);
+}
+
+bool FSpawnAssetTool::ShowComponentPreview(UObject* Asset, UActorFactory* ActorFactory)
+{
+	if (UStaticMesh* PreviewStaticMesh = GetPreviewStaticMesh(Asset, ActorFactory))
+	{
+		ShowMeshPreview(PreviewStaticMesh);
+		return true;
+	}
+
+	// The construction script only runs for the actor which is actually spawned.
+	const UClass* BlueprintClass = GetPreviewBlueprintClass(Asset, ActorFactory);
+	return BlueprintClass != nullptr && BlueprintPreviews.Show(GWorld, BlueprintClass, PreviewActorMaterial, DesignerSettings->PreviewRenderPolicy, PreviewWorldTransform);
+}
+
+bool FSpawnAssetTool::IsComponentPreviewShown() const
+{
+	return (IsValid(MeshPreviewComponent) && MeshPreviewComponent->IsRegistered()) || BlueprintPreviews.IsShown();
+}
+
+void FSpawnAssetTool::ShowMeshPreview(UStaticMesh* StaticMesh)
+{
+	if (!IsValid(MeshPreviewComponent) || StaticMesh == nullptr || GWorld == nullptr)
+		return;
+
+	HideMeshPreview();
+
+	// The component is unregistered, so changing the mesh and the materials doesn't touch the render state.
+	if (MeshPreviewComponent->GetStaticMesh() != StaticMesh)
+	{
+		MeshPreviewComponent->SetStaticMesh(StaticMesh);
+
+		const int32 MaterialCount = MeshPreviewComponent->GetNumMaterials();
+		for (int32 MaterialIndex = 0; MaterialIndex < MaterialCount; MaterialIndex++)
+		{
+			MeshPreviewComponent->SetMaterial(MaterialIndex, PreviewActorMaterial);
+		}
+	}
+
+	DesignerSettings->PreviewRenderPolicy.ApplyTo(MeshPreviewComponent);
+	MeshPreviewComponent->SetWorldTransform(PreviewWorldTransform);
+	MeshPreviewComponent->RegisterComponentWithWorld(GWorld);
+}
+
+void FSpawnAssetTool::HideMeshPreview()
+{
+	if (IsValid(MeshPreviewComponent) && MeshPreviewComponent->IsRegistered())
+	{
+		MeshPreviewComponent->UnregisterComponent();
+	}
+}
+
+AActor* FSpawnAssetTool::AcquirePreviewActor(UActorFactory* Factory, const FAssetData& AssetData)
+{
+	AActor* Actor = PreviewActorPool.Acquire(AssetData);
+	if (Actor != nullptr)
+	{
+		Actor->SetActorTransform(SpawnWorldTransform);
+		return Actor;
+	}
+
+	Actor = SpawnPreviewActorFromFactory(Factory, AssetData, &SpawnWorldTransform, RF_Transient);
+	if (IsValid(Actor))
+	{
+		SetAllMaterialsForActor(Actor, AssetData, PreviewActorMaterial);
+
+		TInlineComponentArray<UPrimitiveComponent*> PrimitiveComponents(Actor, true);
+		for (UPrimitiveComponent* PrimitiveComponent : PrimitiveComponents)
+		{
+			DesignerSettings->PreviewRenderPolicy.ApplyTo(PrimitiveComponent);
+
+			// Keeps the preview out of the placement traces without an ignore list.
+			PrimitiveComponent->SetCollisionProfileName(DesignerSettings->PreviewCollisionProfile.Name);
+		}
+
+		PreviewActorPool.AddActive(AssetData, Actor);
+	}
+
+	return Actor;
 }
 
 AActor* FSpawnAssetTool::SpawnPreviewActorFromFactory(UActorFactory* Factory, const FAssetData& AssetData, const FTransform* InActorTransform, EObjectFlags InObjectFlags)
@@ -551,16 +880,28 @@ AActor* FSpawnAssetTool::SpawnPreviewActorFromFactory(UActorFactory* Factory, co
 			//{
 				//const FScopedTransaction Transaction(NSLOCTEXT("UnrealEd", "CreateActor", "Create Actor"));
 
-				// Create the actor.
+			// Nothing about a preview actor is recorded, even when a transaction is open.
+			TGuardValue<ITransaction*> DisableUndo(GUndo, nullptr);
+
+			// The level still broadcasts the spawn, which should not invalidate the placement trace caches of the tool.
+			TGuardValue<bool> SpawningPreviewActor(bIsSpawningPreviewActor, true);
+
+			// Create the actor as a transient temporary editor actor, so it renders in the level viewports but is hidden from the outliner,
+			// doesn't dirty the level and doesn't notify the level listeners.
 			FActorSpawnParameters ActorSpawnParameters = FActorSpawnParameters();
-			ActorSpawnParameters.ObjectFlags = InObjectFlags;
+			ActorSpawnParameters.Name = MakeUniqueObjectName(DesiredLevel, NewActorTemplate->GetClass(), TEXT("DesignerPreviewActor"));
+			ActorSpawnParameters.ObjectFlags = InObjectFlags | RF_Transient;
+			ActorSpawnParameters.bTemporaryEditorActor = true;
+			ActorSpawnParameters.bHideFromSceneOutliner = true;
 			Actor = Factory->CreateActor(Asset, DesiredLevel, ActorTransform, ActorSpawnParameters);
 			if (Actor != NULL)
 			{
+				// Marks the actor as a preview for the editor and for the level actor events of the tool, like the drag and drop previews.
+				Actor->bIsEditorPreviewActor = true;
+
 				//SelectNone(false, true);
 				//SelectActor(Actor, true, true);
 				//Actor->InvalidateLightingCache();
-				Actor->PostEditMove(true);
 
 				// Make sure the actors visibility reflects that of the level it's in
 				if (!bLevelVisible)
@@ -572,13 +913,6 @@ AActor* FSpawnAssetTool::SpawnPreviewActorFromFactory(UActorFactory* Factory, co
 			}
 
 			//RedrawLevelEditingViewports();
-
-
-			if (Actor)
-			{
-				Actor->MarkPackageDirty();
-				ULevel::LevelDirtiedEvent.Broadcast();
-			}
 			//}
 		}
 		else
@@ -600,157 +934,1082 @@ AActor* FSpawnAssetTool::SpawnPreviewActorFromFactory(UActorFactory* Factory, co
 
 void FSpawnAssetTool::RefreshPlaceableAsset()
 {
-	// Refresh selectable asset array;
-	PlaceableSelectedAssets.Empty();
-	TArray<FAssetData> SelectedAssets;
-	AssetSelectionUtils::GetSelectedAssets(SelectedAssets);
-	for (FAssetData AssetData : SelectedAssets)
-	{
-		if (IsAssetDataPlaceable(AssetData))
-		{
-			PlaceableSelectedAssets.Add(AssetData);
-		}
-	}
-		
-	// Pick random asset to spawn.
-	if (PlaceableSelectedAssets.Num() > 0)
+	FAssetData PickedAssetData;
+	if (PickTarget(TargetAssetDataToSpawn, PickedAssetData, TargetPaletteEntryIndex))
 	{
-		if (PlaceableSelectedAssets.Num() == 1)
-		{
-			TargetAssetDataToSpawn = PlaceableSelectedAssets[0];
-		}
-		else
-		{
-			// Remove previous asset, so a random selected asset is always a new one.
-			PlaceableSelectedAssets.Remove(TargetAssetDataToSpawn);
-			TargetAssetDataToSpawn = PlaceableSelectedAssets[FMath::RandRange(0, PlaceableSelectedAssets.Num() - 1)];
-		}
+		TargetAssetDataToSpawn = PickedAssetData;
 	}
 
-	if (TargetAssetDataToSpawn.GetAsset() != nullptr)
-	{
-		UActorFactory* ActorFactory = FActorFactoryAssetProxy::GetFactoryForAssetObject(TargetAssetDataToSpawn.GetAsset());
-		if (ActorFactory != nullptr)
-		{
-			// Create preview actors.
-			RefreshPreviewActors();
+	ApplyPaletteEntrySettings();
 
-			// Generate random data.
-			RegenerateRandomRotationOffset();
-			RegenerateRandomScale();
+	// Generate random data.
+	RegenerateRandomRotationOffset();
+	RegenerateRandomScale();
 
-			if (PreviewActor != nullptr)
-			{
-				UE_LOG(LogDesigner, Log, TEXT("Storing actor extent."));
-				DefaultSpawnedActorExtent = PreviewActor->CalculateComponentsBoundingBoxInLocalSpace(true).GetExtent();
-			}
-		}
-		else
-		{
-			UE_LOG(LogDesigner, Log, TEXT("SpawnAssetTool: No actor factory for object"));
-		}
-	}
+	// Only the asset which is actually going to be spawned gets loaded.
+	RequestTargetAsset();
 }
 
-bool FSpawnAssetTool::IsAssetDataPlaceable(FAssetData AssetData)
+bool FSpawnAssetTool::PickTarget(const FAssetData& ExcludedAssetData, FAssetData& OutAssetData, int32& OutPaletteEntryIndex)
 {
-	bool bPlaceable = false;
+	OutPaletteEntryIndex = INDEX_NONE;
 
-	UActorFactory* ActorFactory = FActorFactoryAssetProxy::GetFactoryForAssetObject(AssetData.GetAsset());
-	bPlaceable = ActorFactory != nullptr;
-
-	if (AssetData.GetClass() == UBlueprint::StaticClass() && bPlaceable)
+	UDesignerPalette* Palette = DesignerSettings->Palette;
+	if (Palette != nullptr)
 	{
-		// For blueprints, attempt to determine placeability from its tag information
-
-		const FName NativeParentClassTag = TEXT("NativeParentClass");
-		const FName ClassFlagsTag = TEXT("ClassFlags");
+		const int32 EntryIndex = Palette->PickRandomEntryIndex();
+		if (EntryIndex == INDEX_NONE)
+		{
+			UE_LOG(LogDesigner, Log, TEXT("SpawnAssetTool: Palette %s has no placeable entries, save the palette to bake it."), *Palette->GetName());
+			OutAssetData = FAssetData();
+			return true;
+		}
 
-		FString TagValue;
+		IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+		OutAssetData = AssetRegistry.GetAssetByObjectPath(Palette->Entries[EntryIndex].Asset.ToSoftObjectPath().GetAssetPathName());
+		OutPaletteEntryIndex = EntryIndex;
+		return true;
+	}
 
-		if (AssetData.GetTagValue(NativeParentClassTag, TagValue) && !TagValue.IsEmpty())
-		{
-			// If the native parent class can't be placed, neither can the blueprint.
-			UObject* Outer = nullptr;
-			ResolveName(Outer, TagValue, false, false);
-			UClass* NativeParentClass = FindObject<UClass>(ANY_PACKAGE, *TagValue);
+	// Pick random asset to spawn, the selection is kept up to date by the content browser selection events.
+	if (const FAssetData* PickedAssetData = PlaceableSelectedAssets.PickRandom(ExcludedAssetData))
+	{
+		OutAssetData = *PickedAssetData;
+		return true;
+	}
 
-			bPlaceable = AssetSelectionUtils::IsClassPlaceable(NativeParentClass);
-		}
+	return false;
+}
 
-		if (bPlaceable && AssetData.GetTagValue(ClassFlagsTag, TagValue) && !TagValue.IsEmpty())
-		{
-			// Check to see if this class is placeable from its class flags
-			const int32 NotPlaceableFlags = CLASS_NotPlaceable | CLASS_Deprecated | CLASS_Abstract;
-			uint32 ClassFlags = FCString::Atoi(*TagValue);
+void FSpawnAssetTool::ApplyPaletteEntrySettings()
+{
+	SpawnSettings = DesignerSettings;
 
-			bPlaceable = (ClassFlags & NotPlaceableFlags) == CLASS_None;
-		}
+	// Overrides are applied to a copy, so the settings of the user are never changed.
+	const FDesignerPaletteEntry* PaletteEntry = GetTargetPaletteEntry();
+	if (PaletteEntry != nullptr && PaletteEntry->SettingsOverride.HasOverrides())
+	{
+		PaletteEntrySettings->CopySettingsFrom(DesignerSettings);
+		PaletteEntry->SettingsOverride.ApplyTo(PaletteEntrySettings);
+		SpawnSettings = PaletteEntrySettings;
 	}
+}
 
-	return bPlaceable;
+const FDesignerPaletteEntry* FSpawnAssetTool::GetTargetPaletteEntry() const
+{
+	const UDesignerPalette* Palette = DesignerSettings->Palette;
+	return Palette != nullptr && Palette->Entries.IsValidIndex(TargetPaletteEntryIndex) ? &Palette->Entries[TargetPaletteEntryIndex] : nullptr;
 }
 
-bool FSpawnAssetTool::UpdateSpawnVisualizerMaterialParameters()
+bool FSpawnAssetTool::FindKnownExtent(const FAssetData& AssetData, int32 PaletteEntryIndex, FVector& OutExtent) const
 {
-	if (IsValid(SpawnVisualizerMID))
+	// Palette entries have their extent baked, so no bounds have to be calculated.
+	const UDesignerPalette* Palette = DesignerSettings->Palette;
+	if (Palette != nullptr && Palette->Entries.IsValidIndex(PaletteEntryIndex))
 	{
-		SpawnVisualizerMID->SetVectorParameterValue(FName("CursorInputDownWorldLocation"), FLinearColor(SpawnWorldTransform.GetLocation()));
-	
-		const FVector Extent = DefaultSpawnedActorExtent * SpawnedActorScale;
-		const EAxisType PositiveAxis = DesignerSettings->GetPositiveAxisToAlignWithCursor();
-		float ActorRadius = PositiveAxis == EAxisType::Right ? Extent.Y : PositiveAxis == EAxisType::Up ? Extent.Z : Extent.X;
-		ActorRadius = FMath::Abs(ActorRadius);
-	
-		SpawnVisualizerMID->SetVectorParameterValue(FName("CursorPlaneWorldLocation"), FLinearColor(CursorPlaneIntersectionWorldLocation.X, CursorPlaneIntersectionWorldLocation.Y, CursorPlaneIntersectionWorldLocation.Z, ActorRadius));
-	
-		const FLinearColor ForwardVectorColor = PositiveAxis == EAxisType::Up ? FLinearColor::Blue : PositiveAxis == EAxisType::Right ? FLinearColor::Green : FLinearColor::Red;
-		SpawnVisualizerMID->SetVectorParameterValue(FName("ForwardAxisColor"), ForwardVectorColor);
-	
+		OutExtent = Palette->Entries[PaletteEntryIndex].LocalExtent;
 		return true;
 	}
 
-	return false;
+	// The extent was calculated before, so there is no need to calculate the bounds of all components.
+	return ExtentCache.Find(AssetData, OutExtent);
 }
 
-bool FSpawnAssetTool::RecalculateSpawnTransform(FEditorViewportClient* ViewportClient, FViewport* Viewport)
+void FSpawnAssetTool::UpdateTargetExtent(AActor* SpawnedActor)
 {
-	FTransform NewSpawnTransform = FTransform(FQuat::Identity, FVector::ZeroVector, FVector::OneVector);
+	if (FindKnownExtent(TargetAssetDataToSpawn, TargetPaletteEntryIndex, DefaultSpawnedActorExtent))
+		return;
 
-	const int32	HitX = Viewport->GetMouseX();
-	const int32	HitY = Viewport->GetMouseY();
+	if (SpawnedActor != nullptr)
+	{
+		UE_LOG(LogDesigner, Log, TEXT("Storing actor extent."));
+		DefaultSpawnedActorExtent = SpawnedActor->CalculateComponentsBoundingBoxInLocalSpace(true).GetExtent();
+		ExtentCache.Add(TargetAssetDataToSpawn, DefaultSpawnedActorExtent);
+	}
+	else if (IsComponentPreviewShown())
+	{
+		// Template bounds miss what the construction script adds, so they are only kept until an actor is spawned.
+		DefaultSpawnedActorExtent = FAssetBoundsUtils::CalculateLocalExtent(LoadedTargetAsset, DefaultSpawnedActorExtent);
+		ExtentCache.Add(TargetAssetDataToSpawn, DefaultSpawnedActorExtent, FAssetBoundsUtils::HasExactBounds(LoadedTargetAsset));
+	}
+}
 
-	FSceneViewFamilyContext ViewFamily(FSceneViewFamily::ConstructionValues(
-		Viewport,
-		ViewportClient->GetScene(),
-		ViewportClient->EngineShowFlags)
-		.SetRealtimeUpdate(ViewportClient->IsRealtime()));
-	FSceneView* View = ViewportClient->CalcSceneView(&ViewFamily);	
+void FSpawnAssetTool::BeginPrewarm()
+{
+	CancelPrewarm();
 
-	const FViewportCursorLocation Cursor(View, ViewportClient, HitX, HitY);
-	
-	// Trace world, ignore preview actors.
-	const FActorPositionTraceResult TraceResult = FActorPositioning::TraceWorldForPositionWithDefault(Cursor, *View, &PreviewActorArray); 
+	if (!PickTarget(TargetAssetDataToSpawn, PrewarmedTarget.AssetData, PrewarmedTarget.PaletteEntryIndex) || !PrewarmedTarget.AssetData.IsValid())
+	{
+		PrewarmedTarget = FPrewarmedTarget();
+		return;
+	}
 
-	// For some reason the state is default when it fails to hit anything.
-	if (TraceResult.State == FActorPositionTraceResult::Default)
+	if (ResidencyCache.Find(PrewarmedTarget.AssetData, &PrewarmedTarget.ActorFactory) == nullptr && !PrewarmedTarget.AssetData.IsAssetLoaded())
 	{
-		return false;
+		// No callback, the load is picked up by the prewarm steps in the following frames.
+		PrewarmedTarget.StreamingHandle = StreamableManager.RequestAsyncLoad(PrewarmedTarget.AssetData.ToSoftObjectPath());
 	}
+}
 
-	NewSpawnTransform.SetLocation(TraceResult.Location);
+void FSpawnAssetTool::TickPrewarm()
+{
+	if (!PrewarmedTarget.AssetData.IsValid() || PrewarmedTarget.IsReady())
+		return;
 
-	TraceNormal = TraceResult.SurfaceNormal;
+	// The tick is called for every viewport, only do a single step per frame so no frame gets all the work.
+	if (LastPrewarmFrameCounter == GFrameCounter)
+		return;
 
-	FVector RotationUpVector = GetDesignerSettings()->AxisToAlignWithNormal == EAxisType::None ? FVector::UpVector : TraceNormal;
-	FRotator CursorWorldRotation = FRotationMatrix::MakeFromZX(RotationUpVector, FVector::ForwardVector).Rotator();
+	LastPrewarmFrameCounter = GFrameCounter;
 
-	FRotator SpawnRotationSnapped = CursorWorldRotation;
-	FSnappingUtils::SnapRotatorToGrid(SpawnRotationSnapped);
-	CursorWorldRotation.Roll = GetDesignerSettings()->SnapRotationToGrid.X ? SpawnRotationSnapped.Roll : CursorWorldRotation.Roll;
-	CursorWorldRotation.Pitch = GetDesignerSettings()->SnapRotationToGrid.Y ? SpawnRotationSnapped.Pitch : CursorWorldRotation.Pitch;
-	CursorWorldRotation.Yaw = GetDesignerSettings()->SnapRotationToGrid.Z ? SpawnRotationSnapped.Yaw : CursorWorldRotation.Yaw;
-	NewSpawnTransform.SetRotation(CursorWorldRotation.Quaternion());
+	if (PrewarmedTarget.StreamingHandle.IsValid() && PrewarmedTarget.StreamingHandle->IsLoadingInProgress())
+		return;
+
+	if (!IsValid(PrewarmedTarget.Asset))
+	{
+		PrewarmedTarget.Asset = PrewarmedTarget.AssetData.FastGetAsset(false);
+		if (!IsValid(PrewarmedTarget.Asset))
+		{
+			UE_LOG(LogDesigner, Warning, TEXT("SpawnAssetTool: Failed to load %s."), *PrewarmedTarget.AssetData.ObjectPath.ToString());
+			CancelPrewarm();
+		}
+
+		return;
+	}
+
+	if (PrewarmedTarget.ActorFactory == nullptr)
+	{
+		UDesignerPalette* Palette = DesignerSettings->Palette;
+		PrewarmedTarget.ActorFactory = Palette != nullptr && Palette->Entries.IsValidIndex(PrewarmedTarget.PaletteEntryIndex) ? Palette->GetActorFactory(PrewarmedTarget.PaletteEntryIndex) : PlaceableAssetIndex.FindActorFactory(PrewarmedTarget.AssetData);
+		if (PrewarmedTarget.ActorFactory == nullptr)
+		{
+			CancelPrewarm();
+		}
+
+		return;
+	}
+
+	if (!PrewarmedTarget.bHasExtent && FindKnownExtent(PrewarmedTarget.AssetData, PrewarmedTarget.PaletteEntryIndex, PrewarmedTarget.Extent))
+	{
+		PrewarmedTarget.bHasExtent = true;
+		return;
+	}
+
+	if (PrepareComponentPreview(PrewarmedTarget.Asset, PrewarmedTarget.ActorFactory))
+	{
+		// The components are shown when swapped in, only the extent is needed.
+		PrewarmedTarget.bUsesComponentPreview = true;
+		if (!PrewarmedTarget.bHasExtent)
+		{
+			PrewarmedTarget.Extent = FAssetBoundsUtils::CalculateLocalExtent(PrewarmedTarget.Asset);
+			PrewarmedTarget.bHasExtent = true;
+			ExtentCache.Add(PrewarmedTarget.AssetData, PrewarmedTarget.Extent, FAssetBoundsUtils::HasExactBounds(PrewarmedTarget.Asset));
+		}
+
+		return;
+	}
+
+	if (PrewarmedTarget.PreviewActor == nullptr)
+	{
+		AActor* NewPreviewActor = AcquirePreviewActor(PrewarmedTarget.ActorFactory, PrewarmedTarget.AssetData);
+		if (!IsValid(NewPreviewActor))
+		{
+			CancelPrewarm();
+			return;
+		}
+
+		// Keep it out of sight and out of the placement traces until it is swapped in.
+		NewPreviewActor->SetIsTemporarilyHiddenInEditor(true);
+		NewPreviewActor->SetActorEnableCollision(false);
+		PrewarmedTarget.PreviewActor = NewPreviewActor;
+
+		if (!PrewarmedTarget.bHasExtent)
+		{
+			PrewarmedTarget.Extent = NewPreviewActor->CalculateComponentsBoundingBoxInLocalSpace(true).GetExtent();
+			PrewarmedTarget.bHasExtent = true;
+			ExtentCache.Add(PrewarmedTarget.AssetData, PrewarmedTarget.Extent);
+		}
+	}
+}
+
+bool FSpawnAssetTool::SwapInPrewarmedTarget()
+{
+	if (!PrewarmedTarget.IsReady() || (!PrewarmedTarget.bUsesComponentPreview && !IsValid(PrewarmedTarget.PreviewActor)) || !IsValid(PrewarmedTarget.Asset))
+	{
+		CancelPrewarm();
+		return false;
+	}
+
+	// The palette or the selection might have changed while the actor was dragged.
+	const UDesignerPalette* Palette = DesignerSettings->Palette;
+	const bool bIsStillPickable = Palette != nullptr
+		? Palette->Entries.IsValidIndex(PrewarmedTarget.PaletteEntryIndex) && Palette->Entries[PrewarmedTarget.PaletteEntryIndex].Asset.ToSoftObjectPath().GetAssetPathName() == PrewarmedTarget.AssetData.ObjectPath
+		: PlaceableSelectedAssets.Contains(PrewarmedTarget.AssetData);
+
+	if (!bIsStillPickable)
+	{
+		CancelPrewarm();
+		return false;
+	}
+
+	if (TargetAssetStreamingHandle.IsValid())
+	{
+		TargetAssetStreamingHandle->CancelHandle();
+	}
+
+	TargetAssetDataToSpawn = PrewarmedTarget.AssetData;
+	TargetPaletteEntryIndex = PrewarmedTarget.PaletteEntryIndex;
+	TargetAssetStreamingHandle = PrewarmedTarget.StreamingHandle;
+	LoadedTargetAsset = PrewarmedTarget.Asset;
+	TargetActorFactory = PrewarmedTarget.ActorFactory;
+	DefaultSpawnedActorExtent = PrewarmedTarget.Extent;
+
+	ApplyPaletteEntrySettings();
+
+	// Generate random data.
+	RegenerateRandomRotationOffset();
+	RegenerateRandomScale();
+
+	DestroyPreviewActors();
+
+	if (PrewarmedTarget.bUsesComponentPreview)
+	{
+		ShowComponentPreview(LoadedTargetAsset, TargetActorFactory);
+	}
+	else
+	{
+		PreviewActor = PrewarmedTarget.PreviewActor;
+		PreviewActor->SetActorEnableCollision(true);
+		PreviewActor->SetIsTemporarilyHiddenInEditor(false);
+		PreviewActorArray.Add(PreviewActor);
+	}
+
+	// The preview actor is owned by the preview actor array now.
+	PrewarmedTarget = FPrewarmedTarget();
+
+	UpdatePreviewActorTransform();
+
+	return true;
+}
+
+void FSpawnAssetTool::CancelPrewarm()
+{
+	if (PrewarmedTarget.StreamingHandle.IsValid())
+	{
+		PrewarmedTarget.StreamingHandle->CancelHandle();
+	}
+
+	PreviewActorPool.Release(PrewarmedTarget.PreviewActor);
+
+	PrewarmedTarget = FPrewarmedTarget();
+}
+
+void FSpawnAssetTool::OnLevelActorChanged(AActor* Actor)
+{
+	// Preview actors don't collide with the placement traces, but they are still in the actor list of the level.
+	if (bIsSpawningPreviewActor || (Actor != nullptr && Actor->bIsEditorPreviewActor))
+		return;
+
+	PlacementTraces.NotifyActorChanged(Actor);
+	StaticGeometry.NotifyActorChanged(Actor);
+	LandscapeHeightfields.NotifyActorChanged(Actor);
+}
+
+void FSpawnAssetTool::OnBlueprintCompiled()
+{
+	const bool bWasShown = BlueprintPreviews.IsShown();
+	BlueprintPreviews.Empty();
+
+	// The components of the recompiled class might have a different number of material slots.
+	MaterialSlotLayouts.Empty();
+
+	// Show the preview of the recompiled class right away.
+	if (bWasShown && bIsToolActive && !IsValid(ControlledSpawnedActor))
+	{
+		RefreshPreviewActors();
+		UpdatePreviewActorTransform();
+	}
+}
+
+void FSpawnAssetTool::OnUndoRedo()
+{
+	PlacementTraces.Invalidate();
+	StaticGeometry.Validate();
+}
+
+void FSpawnAssetTool::OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacementMap)
+{
+	OnUndoRedo();
+}
+
+void FSpawnAssetTool::OnPlaceableSelectionChanged()
+{
+	// Pooled preview actors of assets which can't be picked anymore are never shown again. The palette entries don't depend on the selection.
+	if (DesignerSettings->Palette == nullptr)
+	{
+		PreviewActorPool.Trim([this](const FName& ObjectPath)
+		{
+			return PlaceableSelectedAssets.Contains(ObjectPath);
+		});
+	}
+
+	// Each prefetched asset is loaded, so only a bounded number is queued and only while the tool is used.
+	if (DesignerSettings->bPrefetchAssetExtents && bIsToolActive)
+	{
+		ExtentCache.Prefetch(PlaceableSelectedAssets.GetAssets(), DesignerSettings->ResidencyCacheMaxAssets);
+	}
+}
+
+void FSpawnAssetTool::RequestTargetAsset()
+{
+	if (TargetAssetStreamingHandle.IsValid())
+	{
+		TargetAssetStreamingHandle->CancelHandle();
+		TargetAssetStreamingHandle.Reset();
+	}
+
+	LoadedTargetAsset = nullptr;
+	TargetActorFactory = nullptr;
+
+	if (!TargetAssetDataToSpawn.IsValid())
+		return;
+
+	// The actor factory of a palette entry is baked.
+	if (GetTargetPaletteEntry() != nullptr)
+	{
+		TargetActorFactory = DesignerSettings->Palette->GetActorFactory(TargetPaletteEntryIndex);
+	}
+
+	// Recently placed assets are kept loaded together with their actor factory.
+	if (ResidencyCache.Find(TargetAssetDataToSpawn, &TargetActorFactory) != nullptr || TargetAssetDataToSpawn.IsAssetLoaded())
+	{
+		OnTargetAssetLoaded();
+		return;
+	}
+
+	// Use the extent from the asset registry until the real bounds are known.
+	DestroyPreviewActors();
+	DefaultSpawnedActorExtent = GetAssetRegistryExtent(TargetAssetDataToSpawn);
+	UpdateTargetExtent(nullptr);
+
+	// The target asset is needed right away, so it goes before the assets which are prefetched.
+	TargetAssetStreamingHandle = StreamableManager.RequestAsyncLoad(TargetAssetDataToSpawn.ToSoftObjectPath(), FStreamableDelegate::CreateRaw(this, &FSpawnAssetTool::OnTargetAssetLoaded), FStreamableManager::AsyncLoadHighPriority);
+}
+
+void FSpawnAssetTool::OnTargetAssetLoaded()
+{
+	LoadedTargetAsset = TargetAssetDataToSpawn.FastGetAsset(false);
+	if (!IsValid(LoadedTargetAsset))
+	{
+		UE_LOG(LogDesigner, Warning, TEXT("SpawnAssetTool: Failed to load %s."), *TargetAssetDataToSpawn.ObjectPath.ToString());
+		ClearPendingSpawn();
+		return;
+	}
+
+	if (TargetActorFactory == nullptr)
+	{
+		TargetActorFactory = PlaceableAssetIndex.FindActorFactory(TargetAssetDataToSpawn);
+	}
+
+	if (TargetActorFactory == nullptr)
+	{
+		UE_LOG(LogDesigner, Log, TEXT("SpawnAssetTool: No actor factory for object"));
+		ClearPendingSpawn();
+		return;
+	}
+
+	if (!bIsToolActive)
+		return;
+
+	if (bHasPendingSpawn)
+	{
+		const bool bPlaceImmediately = bIsPendingSpawnReleased;
+		SpawnWorldTransform = PendingSpawnWorldTransform;
+
+		// The viewport might have been closed while the asset was loading.
+		FEditorViewportClient* ViewportClient = IsViewportClientOpen(PendingSpawnViewportClient) ? PendingSpawnViewportClient : nullptr;
+		ClearPendingSpawn();
+
+		if (ViewportClient != nullptr && SpawnControlledActor(ViewportClient))
+		{
+			UpdateTargetExtent(ControlledSpawnedActor);
+			UpdateSpawnedActorTransform();
+
+			if (bPlaceImmediately)
+			{
+				CompletePlacement();
+			}
+
+			return;
+		}
+	}
+
+	// Replace the bounds proxy with the real preview.
+	RefreshPreviewActors();
+
+	UpdateTargetExtent(PreviewActor);
+
+	UpdatePreviewActorTransform();
+}
+
+FVector FSpawnAssetTool::GetAssetRegistryExtent(const FAssetData& AssetData)
+{
+	// Static meshes store their approximate bounds size as "XxYxZ" in the asset registry.
+	FString ApproxSize;
+	if (AssetData.GetTagValue(TEXT("ApproxSize"), ApproxSize))
+	{
+		TArray<FString> SizeComponents;
+		if (ApproxSize.ParseIntoArray(SizeComponents, TEXT("x")) == 3)
+		{
+			return FVector(FCString::Atof(*SizeComponents[0]), FCString::Atof(*SizeComponents[1]), FCString::Atof(*SizeComponents[2])) * 0.5F;
+		}
+	}
+
+	// Fall back to a one meter cube when the asset has no size information.
+	return FVector(50.F);
+}
+
+bool FSpawnAssetTool::SpawnControlledActor(FEditorViewportClient* ViewportClient)
+{
+	if (!IsTargetAssetReady())
+	{
+		UE_LOG(LogDesigner, Log, TEXT("SpawnAssetTool: No actor factory for object"));
+		return false;
+	}
+
+	DestroyPreviewActors();
+
+	ControlledSpawnedActor = GEditor->UseActorFactory(TargetActorFactory, TargetAssetDataToSpawn, &SpawnWorldTransform);
+	if (ControlledSpawnedActor)
+	{
+		SpawnedActorScale = ControlledSpawnedActor->GetActorScale3D();
+
+		SuspendControlledActorUpdates();
+
+		// Keep the placed asset loaded so it is ready when it is picked again.
+		ResidencyCache.Add(TargetAssetDataToSpawn, LoadedTargetAsset, TargetActorFactory);
+
+		// Prepare the next asset while this actor is dragged.
+		BeginPrewarm();
+	}
+	
+	// Properly reset data.
+	CursorPlaneIntersectionWorldLocation = SpawnWorldTransform.GetLocation();
+	SpawnTracePlane = FPlane();
+
+	// The plane is sized to the drag radius when the material parameters are updated.
+	SpawnPlaneCoveredRadius = 0.F;
+
+	RegisterSpawnPlane(ViewportClient);
+	UpdateSpawnedActorTransform();
+	UpdateSpawnVisualizerMaterialParameters();
+
+	return IsValid(ControlledSpawnedActor);
+}
+
+void FSpawnAssetTool::CompletePlacement()
+{
+	const bool bIsActorSpawned = IsValid(ControlledSpawnedActor);
+
+	DestroyPreviewActors();
+	UnregisterSpawnPlane();
+
+	ReleaseControlledActor();
+
+	// Prepare the next actor but only if the current actor has actually been spawned. The prepared asset is used when it is ready.
+	if (bIsActorSpawned && !SwapInPrewarmedTarget())
+	{
+		RefreshPlaceableAsset();
+	}
+}
+
+void FSpawnAssetTool::ClearPendingSpawn()
+{
+	bHasPendingSpawn = false;
+	bIsPendingSpawnReleased = false;
+	PendingSpawnViewportClient = nullptr;
+}
+
+void FSpawnAssetTool::QueueMouseMove(FEditorViewportClient* ViewportClient, bool bIsCaptured)
+{
+	// High polling rate mice send several moves per frame, only the latest cursor position is traced.
+	if (PendingMouseMoveViewportClient != nullptr)
+	{
+		CoalescedMouseMoveCount++;
+		SET_DWORD_STAT(STAT_DesignerCoalescedMouseMoves, CoalescedMouseMoveCount);
+	}
+
+	PendingMouseMoveViewportClient = ViewportClient;
+	CursorViewportClient = ViewportClient;
+	bIsPendingMouseMoveCaptured = bIsCaptured;
+}
+
+bool FSpawnAssetTool::FViewportRedrawState::Equals(const FViewportRedrawState& Other) const
+{
+	return bIsToolActive == Other.bIsToolActive
+		&& bIsTargetAssetReady == Other.bIsTargetAssetReady
+		&& bIsComponentPreviewShown == Other.bIsComponentPreviewShown
+		&& bIsPreviewActorShown == Other.bIsPreviewActorShown
+		&& bIsSpawnPlaneRegistered == Other.bIsSpawnPlaneRegistered
+		&& PreviewActor == Other.PreviewActor
+		&& PreviewWorldTransform.Equals(Other.PreviewWorldTransform, KINDA_SMALL_NUMBER)
+		&& ControlledActorTransform.Equals(Other.ControlledActorTransform, KINDA_SMALL_NUMBER)
+		&& CursorPlaneIntersectionWorldLocation.Equals(Other.CursorPlaneIntersectionWorldLocation, KINDA_SMALL_NUMBER)
+		&& SpawnedActorScale.Equals(Other.SpawnedActorScale, KINDA_SMALL_NUMBER)
+		&& SpawnVisualizerForwardAxisColor == Other.SpawnVisualizerForwardAxisColor;
+}
+
+FSpawnAssetTool::FViewportRedrawState FSpawnAssetTool::GetViewportRedrawState() const
+{
+	FViewportRedrawState State;
+	State.bIsToolActive = bIsToolActive;
+	State.bIsTargetAssetReady = IsTargetAssetReady();
+	State.bIsComponentPreviewShown = IsComponentPreviewShown();
+	State.bIsPreviewActorShown = IsValid(PreviewActor) && !PreviewActor->IsTemporarilyHiddenInEditor();
+	State.bIsSpawnPlaneRegistered = IsValid(SpawnPlaneComponent) && SpawnPlaneComponent->IsRegistered();
+	State.PreviewActor = PreviewActor;
+	State.PreviewWorldTransform = PreviewWorldTransform;
+	State.ControlledActorTransform = IsValid(ControlledSpawnedActor) ? ControlledSpawnedActor->GetActorTransform() : FTransform::Identity;
+	State.CursorPlaneIntersectionWorldLocation = CursorPlaneIntersectionWorldLocation;
+	State.SpawnedActorScale = SpawnedActorScale;
+	State.SpawnVisualizerForwardAxisColor = SpawnVisualizerForwardAxisColor;
+	return State;
+}
+
+void FSpawnAssetTool::InvalidateViewportIfChanged(FEditorViewportClient* ViewportClient)
+{
+	const FViewportRedrawState State = GetViewportRedrawState();
+	if (State.Equals(LastViewportRedrawState))
+		return;
+
+	LastViewportRedrawState = State;
+
+	// Hit proxies are left alone, the previews are not selectable.
+	ViewportClient->Invalidate(false, false);
+
+	ViewportInvalidationCount++;
+	SET_DWORD_STAT(STAT_DesignerViewportInvalidations, ViewportInvalidationCount);
+}
+
+void FSpawnAssetTool::ClearClosedViewportClients()
+{
+	if (PendingMouseMoveViewportClient != nullptr && !IsViewportClientOpen(PendingMouseMoveViewportClient))
+	{
+		ClearPendingMouseMove();
+	}
+
+	if (CursorViewportClient != nullptr && !IsViewportClientOpen(CursorViewportClient))
+	{
+		CursorViewportClient = nullptr;
+		LastViewportRedrawState = FViewportRedrawState();
+	}
+
+	if (AsyncTraceViewportClient != nullptr && !IsViewportClientOpen(AsyncTraceViewportClient))
+	{
+		CancelAsyncSpawnTrace();
+	}
+}
+
+bool FSpawnAssetTool::IsViewportClientOpen(const FEditorViewportClient* ViewportClient)
+{
+	return ViewportClient != nullptr && GEditor != nullptr && GEditor->GetAllViewportClients().Contains(ViewportClient);
+}
+
+void FSpawnAssetTool::FlushPendingMouseMove()
+{
+	FEditorViewportClient* ViewportClient = PendingMouseMoveViewportClient;
+	ClearPendingMouseMove();
+
+	// The mouse move may have been queued by another viewport, which was closed since.
+	if (!IsViewportClientOpen(ViewportClient) || ViewportClient->Viewport == nullptr)
+		return;
+
+	FViewport* Viewport = ViewportClient->Viewport;
+
+	if (bIsPendingMouseMoveCaptured)
+	{
+		if (IsValid(ControlledSpawnedActor))
+		{
+			RecalculateMousePlaneIntersectionWorldLocation(ViewportClient, Viewport);
+			UpdateSpawnedActorTransform();
+			UpdateSpawnVisualizerMaterialParameters();
+		}
+	}
+	else if (bIsToolActive && !IsValid(ControlledSpawnedActor))
+	{
+		if (PreviewActorArray.Num() == 0 && !IsComponentPreviewShown())
+		{
+			RefreshPreviewActors();
+		}
+
+		// The async trace can only filter its hit like the designer placement trace, not like the editor's own placement trace.
+		if (DesignerSettings->bUseAsyncHoverTraces && DesignerSettings->bUseDesignerPlacementTrace)
+		{
+			// The preview is moved when the trace completed.
+			RequestAsyncSpawnTrace(ViewportClient, Viewport);
+			return;
+		}
+
+		RecalculateSpawnTransform(ViewportClient, Viewport);
+
+		// Update the cursor plane world location to be the same as the spawn location so the rotation calculation is done properly.
+		CursorPlaneIntersectionWorldLocation = SpawnWorldTransform.GetLocation();
+
+		UpdatePreviewActorTransform();
+	}
+}
+
+void FSpawnAssetTool::RequestAsyncSpawnTrace(FEditorViewportClient* ViewportClient, FViewport* Viewport)
+{
+	UWorld* World = ViewportClient->GetWorld();
+	const FSceneView* View = ViewportViews.GetView(ViewportClient);
+	if (World == nullptr || View == nullptr)
+		return;
+
+	const FViewportCursorLocation Cursor(View, ViewportClient, Viewport->GetMouseX(), Viewport->GetMouseY());
+
+	FActorPositionTraceResult TraceResult;
+	if (PlacementTraces.Find(World, Cursor.GetOrigin(), Cursor.GetDirection(), TraceResult))
+	{
+		CancelAsyncSpawnTrace();
+		ApplyHoverTraceResult(World, TraceResult);
+		return;
+	}
+
+	// The landscape fast path doesn't need the physics scene, so there is nothing to wait for.
+	if (TraceLandscapeForPosition(World, Cursor.GetOrigin(), Cursor.GetDirection(), View->Family->EngineShowFlags, TraceResult))
+	{
+		CancelAsyncSpawnTrace();
+		PlacementTraces.Store(World, Cursor.GetOrigin(), Cursor.GetDirection(), TraceResult);
+		ApplyHoverTraceResult(World, TraceResult);
+		return;
+	}
+
+	// Latest wins, the result of the previous trace is never applied.
+	if (AsyncTraceHandle.IsValid())
+	{
+		DroppedAsyncTraceCount++;
+		SET_DWORD_STAT(STAT_DesignerDroppedAsyncTraces, DroppedAsyncTraceCount);
+	}
+
+	// The same query as the first trace of the designer placement trace, the preview actors use a collision profile which doesn't respond to it.
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(DesignerAsyncPlacementTrace), true);
+	QueryParams.bReturnPhysicalMaterial = false;
+
+	const FVector TraceEndLocation = Cursor.GetOrigin() + Cursor.GetDirection() * WORLD_MAX;
+	if (DesignerSettings->PlacementTraceObjectTypes.Num() > 0)
+	{
+		AsyncTraceHandle = World->AsyncLineTraceByObjectType(EAsyncTraceType::Single, Cursor.GetOrigin(), TraceEndLocation, FCollisionObjectQueryParams(DesignerSettings->PlacementTraceObjectTypes), QueryParams);
+	}
+	else
+	{
+		AsyncTraceHandle = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Cursor.GetOrigin(), TraceEndLocation, DesignerSettings->PlacementTraceChannel, QueryParams);
+	}
+	AsyncTraceWorld = World;
+	AsyncTraceViewportClient = ViewportClient;
+	AsyncTraceFrameCounter = GFrameCounter;
+	AsyncTraceOrigin = Cursor.GetOrigin();
+	AsyncTraceDirection = Cursor.GetDirection();
+	AsyncTraceShowFlags = View->Family->EngineShowFlags;
+}
+
+void FSpawnAssetTool::TickAsyncSpawnTrace(FEditorViewportClient* ViewportClient)
+{
+	if (!AsyncTraceHandle.IsValid())
+		return;
+
+	UWorld* World = AsyncTraceWorld.Get();
+
+	FTraceDatum TraceDatum;
+	if (World != nullptr && World->QueryTraceData(AsyncTraceHandle, TraceDatum))
+	{
+		const FActorPositionTraceResult TraceResult = MakeTraceResult(World, TraceDatum);
+		CancelAsyncSpawnTrace();
+
+		// Stored like the synchronous trace, so a click on the hovered pixel doesn't trace again.
+		PlacementTraces.Store(World, AsyncTraceOrigin, AsyncTraceDirection, TraceResult);
+
+		if (!IsValid(ControlledSpawnedActor))
+		{
+			ApplyHoverTraceResult(World, TraceResult);
+		}
+		return;
+	}
+
+	// The result is only kept for the frame after the trace ran, if it was missed trace synchronously instead.
+	if ((World == nullptr || GFrameCounter > AsyncTraceFrameCounter + 2) && ViewportClient == AsyncTraceViewportClient)
+	{
+		UE_LOG(LogDesigner, Verbose, TEXT("SpawnAssetTool: Async trace result was not available, trace synchronously."));
+		CancelAsyncSpawnTrace();
+
+		if (!IsValid(ControlledSpawnedActor) && ViewportClient->Viewport != nullptr)
+		{
+			RecalculateSpawnTransform(ViewportClient, ViewportClient->Viewport);
+			CursorPlaneIntersectionWorldLocation = SpawnWorldTransform.GetLocation();
+			UpdatePreviewActorTransform();
+		}
+	}
+}
+
+FActorPositionTraceResult FSpawnAssetTool::MakeTraceResult(const UWorld* World, const FTraceDatum& TraceDatum) const
+{
+	const FEngineShowFlags* ShowFlags = AsyncTraceShowFlags.GetPtrOrNull();
+
+	if (TraceDatum.OutHits.Num() == 0)
+	{
+		FActorPositionTraceResult TraceResult;
+		TraceResult.State = FActorPositionTraceResult::Default;
+		return TraceResult;
+	}
+
+	const FHitResult& Hit = TraceDatum.OutHits[0];
+	if (FPlacementTrace::IsHitValid(Hit, ShowFlags))
+		return FPlacementTrace::MakeTraceResult(Hit);
+
+	return FPlacementTrace::Trace(World, AsyncTraceOrigin, AsyncTraceDirection, DesignerSettings->PlacementTraceChannel, DesignerSettings->PlacementTraceObjectTypes, ShowFlags);
+}
+
+void FSpawnAssetTool::ApplyHoverTraceResult(UWorld* World, const FActorPositionTraceResult& TraceResult)
+{
+	if (!bIsToolActive || !ApplySpawnTraceResult(World, TraceResult))
+		return;
+
+	// Update the cursor plane world location to be the same as the spawn location so the rotation calculation is done properly.
+	CursorPlaneIntersectionWorldLocation = SpawnWorldTransform.GetLocation();
+
+	UpdatePreviewActorTransform();
+}
+
+bool FSpawnAssetTool::UpdateSpawnVisualizerMaterialParameters()
+{
+	if (IsValid(SpawnVisualizerMID))
+	{
+		SpawnVisualizerMID->SetVectorParameterByIndex(CursorInputDownWorldLocationParameterIndex, FLinearColor(SpawnWorldTransform.GetLocation()));
+	
+		const FVector Extent = DefaultSpawnedActorExtent * SpawnedActorScale;
+		const EAxisType PositiveAxis = GetSpawnSettings()->GetPositiveAxisToAlignWithCursor();
+		float ActorRadius = PositiveAxis == EAxisType::Right ? Extent.Y : PositiveAxis == EAxisType::Up ? Extent.Z : Extent.X;
+		ActorRadius = FMath::Abs(ActorRadius);
+	
+		SpawnVisualizerMID->SetVectorParameterByIndex(CursorPlaneWorldLocationParameterIndex, FLinearColor(CursorPlaneIntersectionWorldLocation.X, CursorPlaneIntersectionWorldLocation.Y, CursorPlaneIntersectionWorldLocation.Z, ActorRadius));
+	
+		const FLinearColor ForwardVectorColor = PositiveAxis == EAxisType::Up ? FLinearColor::Blue : PositiveAxis == EAxisType::Right ? FLinearColor::Green : FLinearColor::Red;
+		if (ForwardVectorColor != SpawnVisualizerForwardAxisColor)
+		{
+			SpawnVisualizerForwardAxisColor = ForwardVectorColor;
+			SpawnVisualizerMID->SetVectorParameterByIndex(ForwardAxisColorParameterIndex, ForwardVectorColor);
+		}
+
+		UpdateSpawnPlaneBounds(FVector::Dist(SpawnWorldTransform.GetLocation(), CursorPlaneIntersectionWorldLocation) + ActorRadius);
+	
+		return true;
+	}
+
+	return false;
+}
+
+void FSpawnAssetTool::UpdateSpawnPlaneBounds(float DragRadius)
+{
+	if (!IsValid(SpawnPlaneComponent) || SpawnPlaneMeshSize <= 0.F || DragRadius <= SpawnPlaneCoveredRadius)
+		return;
+
+	// Grow in steps, so the plane isn't moved on every mouse move while still only covering the area around the drag radius.
+	SpawnPlaneCoveredRadius = FMath::Max(DragRadius * 2.F, 100.F);
+
+	FTransform SpawnVisualizerTransform = SpawnWorldTransform;
+	SpawnVisualizerTransform.SetScale3D(FVector(2.F * SpawnPlaneCoveredRadius / SpawnPlaneMeshSize));
+	SpawnPlaneComponent->SetRelativeTransform(SpawnVisualizerTransform);
+}
+
+bool FSpawnAssetTool::RecalculateSpawnTransform(FEditorViewportClient* ViewportClient, FViewport* Viewport)
+{
+	const int32	HitX = Viewport->GetMouseX();
+	const int32	HitY = Viewport->GetMouseY();
+
+	const FSceneView* View = ViewportViews.GetView(ViewportClient);
+	if (View == nullptr)
+	{
+		return false;
+	}
+
+	const FViewportCursorLocation Cursor(View, ViewportClient, HitX, HitY);
+	
+	// Trace world, ignore preview actors. A click reuses the trace of the hover at the same pixel.
+	FActorPositionTraceResult TraceResult;
+	if (!PlacementTraces.Find(ViewportClient->GetWorld(), Cursor.GetOrigin(), Cursor.GetDirection(), TraceResult))
+	{
+		if (!TraceLandscapeForPosition(ViewportClient->GetWorld(), Cursor.GetOrigin(), Cursor.GetDirection(), View->Family->EngineShowFlags, TraceResult))
+		{
+			TraceResult = DesignerSettings->bUseDesignerPlacementTrace
+				? FPlacementTrace::Trace(ViewportClient->GetWorld(), Cursor.GetOrigin(), Cursor.GetDirection(), DesignerSettings->PlacementTraceChannel, DesignerSettings->PlacementTraceObjectTypes, &View->Family->EngineShowFlags)
+				: FActorPositioning::TraceWorldForPositionWithDefault(Cursor, *View, &PreviewActorArray);
+		}
+		PlacementTraces.Store(ViewportClient->GetWorld(), Cursor.GetOrigin(), Cursor.GetDirection(), TraceResult);
+	}
+
+	return ApplySpawnTraceResult(ViewportClient->GetWorld(), TraceResult);
+}
+
+bool FSpawnAssetTool::TraceLandscapeForPosition(const UWorld* World, const FVector& RayOrigin, const FVector& RayDirection, const FEngineShowFlags& ShowFlags, FActorPositionTraceResult& OutResult)
+{
+	if (!DesignerSettings->bUseLandscapeHeightfieldPlacement || !DesignerSettings->bBuildStaticGeometryBVH || !ShowFlags.Landscape || World == nullptr)
+		return false;
+
+	FActorPositionTraceResult LandscapeResult;
+	if (!LandscapeHeightfields.Raycast(World, RayOrigin, RayDirection, WORLD_MAX, LandscapeResult))
+		return false;
+
+	// Test for anything in front of the landscape against the static geometry instead of the physics scene, stopping just short of the landscape.
+	// Without an up to date snapshot covering the whole ray, or when the ray passes the bounds of anything else, the placement trace decides.
+	const FVector TestEndLocation = LandscapeResult.Location - RayDirection;
+
+	FStaticGeometryRay OcclusionRay;
+	OcclusionRay.Origin = (FVector3f)RayOrigin;
+	OcclusionRay.Direction = (FVector3f)RayDirection;
+	OcclusionRay.MaxDistance = FVector::Dist(RayOrigin, TestEndLocation);
+
+	if (!StaticGeometry.CanTestOcclusion(RayOrigin, TestEndLocation) || StaticGeometry.GetSnapshot()->IsOccluded(OcclusionRay))
+	{
+		LandscapeHeightfieldFallbackCount++;
+		return false;
+	}
+
+	LandscapeHeightfieldHitCount++;
+	OutResult = LandscapeResult;
+	return true;
+}
+
+FVector FSpawnAssetTool::EstimateSurfaceNormal(UWorld* World, const FActorPositionTraceResult& TraceResult)
+{
+	const FVector Center = TraceResult.Location;
+	const FVector HitNormal = TraceResult.SurfaceNormal.GetSafeNormal();
+	if (HitNormal.IsZero())
+		return TraceResult.SurfaceNormal;
+
+	if (Center.Equals(LastEstimatedNormalLocation) && HitNormal.Equals(LastEstimatedNormalSurfaceNormal))
+		return LastEstimatedNormal;
+
+	// The samples of this hit are still being traced.
+	if (SurfaceNormalTraceHandles.Num() > 0 && Center.Equals(SurfaceNormalTraceResult.Location) && HitNormal.Equals(SurfaceNormalTraceResult.SurfaceNormal.GetSafeNormal()))
+		return ProvisionalEstimatedNormal;
+
+	const int32 NumSamples = FMath::Clamp(GetSpawnSettings()->SurfaceNormalSampleCount, 3, 32);
+	const float Radius = FMath::Max(GetSpawnSettings()->SurfaceNormalSampleRadius, 1.F);
+
+	FVector TangentX;
+	FVector TangentY;
+	HitNormal.FindBestAxisVectors(TangentX, TangentY);
+
+	// The samples are traced down along the hit normal, from above the surface in a circle around the hit.
+	TArray<FStaticGeometryRay, TInlineAllocator<32>> Rays;
+	for (int32 SampleIndex = 0; SampleIndex < NumSamples; SampleIndex++)
+	{
+		float Sin;
+		float Cos;
+		FMath::SinCos(&Sin, &Cos, 2.F * PI * SampleIndex / NumSamples);
+
+		FStaticGeometryRay& Ray = Rays.AddDefaulted_GetRef();
+		Ray.Origin = (FVector3f)(Center + HitNormal * Radius + (TangentX * Cos + TangentY * Sin) * Radius);
+		Ray.Direction = (FVector3f)-HitNormal;
+		Ray.MaxDistance = 2.F * Radius;
+	}
+
+	TArray<FStaticGeometryHit, TInlineAllocator<32>> Hits;
+	Hits.SetNum(NumSamples);
+
+	TArray<bool, TInlineAllocator<32>> ResolvedSamples;
+	ResolvedSamples.Init(false, NumSamples);
+
+	// Traced in packets without the physics scene, larger stencils are spread over the worker threads.
+	// A sample is only resolved when nothing which isn't static geometry can be in front of its hit, and a miss only when the landscapes were sampled too.
+	const FStaticGeometrySnapshotPtr StaticGeometrySnapshot = StaticGeometry.GetSnapshot();
+	if (StaticGeometrySnapshot.IsValid())
+	{
+		StaticGeometrySnapshot->RaycastBatch(Rays, Hits);
+
+		const bool bSampleLandscapes = DesignerSettings->bUseLandscapeHeightfieldPlacement;
+		for (int32 SampleIndex = 0; SampleIndex < NumSamples; SampleIndex++)
+		{
+			const FVector RayOrigin = (FVector)Rays[SampleIndex].Origin;
+			const FVector RayDirection = (FVector)Rays[SampleIndex].Direction;
+			if (!StaticGeometry.CanTestOcclusion(RayOrigin, RayOrigin + RayDirection * Rays[SampleIndex].MaxDistance))
+				continue;
+
+			FStaticGeometryHit& Hit = Hits[SampleIndex];
+			FActorPositionTraceResult LandscapeResult;
+			if (bSampleLandscapes && LandscapeHeightfields.Raycast(World, RayOrigin, RayDirection, FMath::Min(Hit.Distance, Rays[SampleIndex].MaxDistance), LandscapeResult))
+			{
+				Hit.Distance = FVector::Dist(RayOrigin, LandscapeResult.Location);
+				Hit.Location = (FVector3f)LandscapeResult.Location;
+				Hit.Normal = (FVector3f)LandscapeResult.SurfaceNormal;
+				Hit.Component.Reset();
+			}
+
+			if (!Hit.IsHit() && !bSampleLandscapes)
+				continue;
+
+			FStaticGeometryRay OcclusionRay = Rays[SampleIndex];
+			OcclusionRay.MaxDistance = FMath::Max(FMath::Min(Hit.Distance, OcclusionRay.MaxDistance) - 1.F, 0.F);
+			ResolvedSamples[SampleIndex] = !StaticGeometrySnapshot->IsOccluded(OcclusionRay);
+		}
+	}
+
+	// The other samples are traced async with the same query as the placement trace, so no sample is traced synchronously on the game thread.
+	TArray<FTraceHandle, TInlineAllocator<32>> TraceHandles;
+	if (World != nullptr && ResolvedSamples.Contains(false))
+	{
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(DesignerSurfaceNormalTrace), true);
+		QueryParams.bReturnPhysicalMaterial = false;
+
+		// FActorPositioning ignores the preview actors, the designer trace relies on their collision profile instead.
+		if (!DesignerSettings->bUseDesignerPlacementTrace)
+		{
+			QueryParams.AddIgnoredActors(PreviewActorArray);
+		}
+
+		TraceHandles.SetNum(NumSamples);
+		for (int32 SampleIndex = 0; SampleIndex < NumSamples; SampleIndex++)
+		{
+			if (ResolvedSamples[SampleIndex])
+				continue;
+
+			Hits[SampleIndex] = FStaticGeometryHit();
+
+			const FVector TraceStartLocation = (FVector)Rays[SampleIndex].Origin;
+			const FVector TraceEndLocation = TraceStartLocation + (FVector)Rays[SampleIndex].Direction * Rays[SampleIndex].MaxDistance;
+			if (!DesignerSettings->bUseDesignerPlacementTrace)
+			{
+				// FActorPositioning traces every object type.
+				TraceHandles[SampleIndex] = World->AsyncLineTraceByObjectType(EAsyncTraceType::Single, TraceStartLocation, TraceEndLocation, FCollisionObjectQueryParams(FCollisionObjectQueryParams::InitType::AllObjects), QueryParams);
+			}
+			else if (DesignerSettings->PlacementTraceObjectTypes.Num() > 0)
+			{
+				TraceHandles[SampleIndex] = World->AsyncLineTraceByObjectType(EAsyncTraceType::Single, TraceStartLocation, TraceEndLocation, FCollisionObjectQueryParams(DesignerSettings->PlacementTraceObjectTypes), QueryParams);
+			}
+			else
+			{
+				TraceHandles[SampleIndex] = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, TraceStartLocation, TraceEndLocation, DesignerSettings->PlacementTraceChannel, QueryParams);
+			}
+		}
+	}
+
+	const FVector EstimatedNormal = FitSurfaceNormal(Center, HitNormal, Hits);
+
+	// A newer hit replaces the pending estimate.
+	CancelSurfaceNormalTraces();
+
+	if (TraceHandles.Num() > 0)
+	{
+		SurfaceNormalTraceResult = TraceResult;
+		SurfaceNormalSampleHits = MoveTemp(Hits);
+		SurfaceNormalTraceHandles = MoveTemp(TraceHandles);
+		SurfaceNormalTraceWorld = World;
+		SurfaceNormalTraceFrameCounter = GFrameCounter;
+		ProvisionalEstimatedNormal = EstimatedNormal;
+		return EstimatedNormal;
+	}
+
+	LastEstimatedNormalLocation = Center;
+	LastEstimatedNormalSurfaceNormal = HitNormal;
+	LastEstimatedNormal = EstimatedNormal;
+
+	return EstimatedNormal;
+}
+
+void FSpawnAssetTool::TickSurfaceNormalTraces()
+{
+	if (SurfaceNormalTraceHandles.Num() == 0)
+		return;
+
+	UWorld* World = SurfaceNormalTraceWorld.Get();
+	bool bIsComplete = World != nullptr;
+	for (int32 SampleIndex = 0; SampleIndex < SurfaceNormalTraceHandles.Num() && bIsComplete; SampleIndex++)
+	{
+		FTraceHandle& TraceHandle = SurfaceNormalTraceHandles[SampleIndex];
+		if (!TraceHandle.IsValid())
+			continue;
+
+		FTraceDatum TraceDatum;
+		if (!World->QueryTraceData(TraceHandle, TraceDatum))
+		{
+			bIsComplete = false;
+			break;
+		}
+
+		// Only the first blocking hit is returned, a hit on something invisible leaves the sample out.
+		TraceHandle.Invalidate();
+		if (TraceDatum.OutHits.Num() > 0 && FPlacementTrace::IsHitValid(TraceDatum.OutHits[0], nullptr))
+		{
+			SurfaceNormalSampleHits[SampleIndex].Distance = TraceDatum.OutHits[0].Distance;
+			SurfaceNormalSampleHits[SampleIndex].Location = (FVector3f)TraceDatum.OutHits[0].ImpactPoint;
+		}
+	}
+
+	// The results are only kept for the frame after the traces ran, when they were missed the samples which are known are used.
+	if (!bIsComplete && World != nullptr && GFrameCounter <= SurfaceNormalTraceFrameCounter + 2)
+		return;
+
+	const FActorPositionTraceResult TraceResult = SurfaceNormalTraceResult;
+	LastEstimatedNormalLocation = TraceResult.Location;
+	LastEstimatedNormalSurfaceNormal = TraceResult.SurfaceNormal.GetSafeNormal();
+	LastEstimatedNormal = FitSurfaceNormal(LastEstimatedNormalLocation, LastEstimatedNormalSurfaceNormal, SurfaceNormalSampleHits);
+	CancelSurfaceNormalTraces();
+
+	// The preview still uses the provisional normal while the cursor is on the same hit.
+	if (World != nullptr && !IsValid(ControlledSpawnedActor) && SpawnWorldTransform.GetLocation().Equals(TraceResult.Location))
+	{
+		ApplyHoverTraceResult(World, TraceResult);
+	}
+}
+
+FVector FSpawnAssetTool::FitSurfaceNormal(const FVector& Center, const FVector& HitNormal, TArrayView<const FStaticGeometryHit> Hits)
+{
+	TArray<FVector, TInlineAllocator<32>> SamplePoints;
+	for (const FStaticGeometryHit& Hit : Hits)
+	{
+		if (Hit.IsHit())
+		{
+			SamplePoints.Add((FVector)Hit.Location);
+		}
+	}
+
+	if (SamplePoints.Num() < 3)
+		return HitNormal;
+
+	FVector NormalSum = FVector::ZeroVector;
+	for (int32 Index = 0; Index < SamplePoints.Num(); Index++)
+	{
+		NormalSum += FVector::CrossProduct(SamplePoints[Index] - Center, SamplePoints[(Index + 1) % SamplePoints.Num()] - Center);
+	}
+
+	NormalSum = (NormalSum | HitNormal) < 0.0 ? -NormalSum : NormalSum;
+	const FVector EstimatedNormal = NormalSum.GetSafeNormal();
+	return EstimatedNormal.IsZero() ? HitNormal : EstimatedNormal;
+}
+
+bool FSpawnAssetTool::ApplySpawnTraceResult(UWorld* World, const FActorPositionTraceResult& TraceResult)
+{
+	FTransform NewSpawnTransform = FTransform(FQuat::Identity, FVector::ZeroVector, FVector::OneVector);
+
+	// For some reason the state is default when it fails to hit anything.
+	if (TraceResult.State == FActorPositionTraceResult::Default)
+	{
+		return false;
+	}
+
+	NewSpawnTransform.SetLocation(TraceResult.Location);
+
+	TraceNormal = GetSpawnSettings()->bEstimateSurfaceNormal && GetSpawnSettings()->AxisToAlignWithNormal != EAxisType::None ? EstimateSurfaceNormal(World, TraceResult) : TraceResult.SurfaceNormal;
+
+	FVector RotationUpVector = GetSpawnSettings()->AxisToAlignWithNormal == EAxisType::None ? FVector::UpVector : TraceNormal;
+	FRotator CursorWorldRotation = FRotationMatrix::MakeFromZX(RotationUpVector, FVector::ForwardVector).Rotator();
+
+	FRotator SpawnRotationSnapped = CursorWorldRotation;
+	FSnappingUtils::SnapRotatorToGrid(SpawnRotationSnapped);
+	CursorWorldRotation.Roll = GetSpawnSettings()->SnapRotationToGrid.X ? SpawnRotationSnapped.Roll : CursorWorldRotation.Roll;
+	CursorWorldRotation.Pitch = GetSpawnSettings()->SnapRotationToGrid.Y ? SpawnRotationSnapped.Pitch : CursorWorldRotation.Pitch;
+	CursorWorldRotation.Yaw = GetSpawnSettings()->SnapRotationToGrid.Z ? SpawnRotationSnapped.Yaw : CursorWorldRotation.Yaw;
+	NewSpawnTransform.SetRotation(CursorWorldRotation.Quaternion());
 
 	SpawnWorldTransform = NewSpawnTransform;
 	
@@ -759,16 +2018,11 @@ bool FSpawnAssetTool::RecalculateSpawnTransform(FEditorViewportClient* ViewportC
 
 void FSpawnAssetTool::RecalculateMousePlaneIntersectionWorldLocation(FEditorViewportClient* ViewportClient, FViewport* Viewport)
 {
-	FSceneViewFamilyContext ViewFamily(FSceneViewFamily::ConstructionValues(
-		Viewport,
-		ViewportClient->GetScene(),
-		ViewportClient->EngineShowFlags)
-		.SetRealtimeUpdate(ViewportClient->IsRealtime()));
-	// SceneView is deleted with the ViewFamily
-	FSceneView* SceneView = ViewportClient->CalcSceneView(&ViewFamily);
-	FViewportCursorLocation MouseViewportRay(SceneView, ViewportClient, Viewport->GetMouseX(), Viewport->GetMouseY());
+	const FSceneView* SceneView = ViewportViews.GetView(ViewportClient);
+	if (SceneView == nullptr)
+		return;
 
-	FViewportCursorLocation ViewportCenterRay(SceneView, ViewportClient, Viewport->GetSizeXY().X * 0.5F, Viewport->GetSizeXY().Y * 0.5F);
+	const FViewportCursorLocation MouseViewportRay(SceneView, ViewportClient, Viewport->GetMouseX(), Viewport->GetMouseY());
 
 	FVector TraceStartLocation = MouseViewportRay.GetOrigin();
 	FVector TraceDirection = MouseViewportRay.GetDirection();
@@ -780,59 +2034,45 @@ void FSpawnAssetTool::RecalculateMousePlaneIntersectionWorldLocation(FEditorView
 
 void FSpawnAssetTool::UpdatePreviewActorTransform()
 {
-	FTransform NewSpawnedActorTransform = SpawnWorldTransform;
-	NewSpawnedActorTransform.SetScale3D(GetSpawnActorScale());
-	NewSpawnedActorTransform.SetRotation(GetSpawnActorRotation().Quaternion());
-	
-	FVector RelativeLocationOffset = GetDesignerSettings()->RelativeLocationOffset;
-	if (GetDesignerSettings()->bScaleRelativeLocationOffset)
-	{
-		RelativeLocationOffset *= GetSpawnActorScale();
-	}
+	PreviewWorldTransform = ComposeSpawnActorTransform(GetSpawnActorRotation().Quaternion(), GetSpawnActorScale());
 
-	FVector WorldLocationOffset = GetDesignerSettings()->WorldLocationOffset;
-	if (GetDesignerSettings()->bScaleWorldLocationOffset)
+	if (IsValid(MeshPreviewComponent) && MeshPreviewComponent->IsRegistered())
 	{
-		WorldLocationOffset *= GetSpawnActorScale();
+		// The component has no owner, no parent and no children, so only its own render transform is updated.
+		MeshPreviewComponent->SetWorldTransform(PreviewWorldTransform);
 	}
 
-	WorldLocationOffset += TraceNormal * ActorScrollWheelOffset * DefaultSpawnedActorExtent * DesignerSettings->ScrollWheelOffsetScale;
+	BlueprintPreviews.SetTransform(PreviewWorldTransform);
 
 	if (PreviewActor != nullptr)
 	{
-		PreviewActor->SetActorTransform(NewSpawnedActorTransform);
-		PreviewActor->AddActorLocalOffset(RelativeLocationOffset);
-		PreviewActor->AddActorWorldOffset(WorldLocationOffset);
+		ApplyActorTransform(PreviewActor, PreviewWorldTransform);
 	}
 
 	if (PreviewActorPulsing != nullptr)
 	{
-		PreviewActorPulsing->SetActorTransform(NewSpawnedActorTransform);
-		PreviewActorPulsing->AddActorLocalOffset(RelativeLocationOffset);
-		PreviewActorPulsing->AddActorWorldOffset(WorldLocationOffset);
+		ApplyActorTransform(PreviewActorPulsing, PreviewWorldTransform);
 	}
-
 }
 
 void FSpawnAssetTool::UpdateSpawnedActorTransform()
 {
-	FTransform NewSpawnedActorTransform = SpawnWorldTransform;
-
 	FVector CursorDirection;
 	float CursorDistance;
 	(CursorPlaneIntersectionWorldLocation - SpawnWorldTransform.GetLocation()).ToDirectionAndLength(CursorDirection, CursorDistance);
 
 	FVector NewScale = GetSpawnActorScale();
+	const FVector MinimalScale = GetSpawnSettings()->GetScale();
 
 	// If the object also scales towards the mouse we use the random scale as a ratio
-	if (GetDesignerSettings()->bScaleBoundsTowardsCursor)
+	if (GetSpawnSettings()->bScaleBoundsTowardsCursor)
 	{
 		NewScale /= FMath::Max(NewScale.X, FMath::Max(NewScale.Y, NewScale.Z));
 	}
 
-	if (GetDesignerSettings()->bScaleBoundsTowardsCursor)
+	if (GetSpawnSettings()->bScaleBoundsTowardsCursor)
 	{
-		EAxisType PositiveAxis = GetDesignerSettings()->GetPositiveAxisToAlignWithCursor();
+		EAxisType PositiveAxis = GetSpawnSettings()->GetPositiveAxisToAlignWithCursor();
 		float BoundsUsedForScale;
 		if (PositiveAxis == EAxisType::Forward)
 			BoundsUsedForScale = DefaultSpawnedActorExtent.X;
@@ -848,63 +2088,73 @@ void FSpawnAssetTool::UpdateSpawnedActorTransform()
 
 	if (NewScale.ContainsNaN())
 	{
-		NewScale = FVector(GetDesignerSettings()->GetScale());
+		NewScale = MinimalScale;
 		UE_LOG(LogDesigner, Warning, TEXT("New scale contained NaN, so it is set to the minimal scale. DefaultDesignerActorExtent = %s."), *DefaultSpawnedActorExtent.ToString());
 	}
 
 	// Clamp the scale by minimum scale value.
 	FVector ClampedAbsoluteNewScale = NewScale.GetAbs();
-	ClampedAbsoluteNewScale = ClampedAbsoluteNewScale.ComponentMax(GetDesignerSettings()->GetScale());
+	ClampedAbsoluteNewScale = ClampedAbsoluteNewScale.ComponentMax(MinimalScale);
 	NewScale = NewScale.GetSignVector() * ClampedAbsoluteNewScale;
 
-	NewSpawnedActorTransform.SetScale3D(NewScale);
-
-	NewSpawnedActorTransform.SetRotation(GetSpawnActorRotation().Quaternion());
-	
-	FVector RelativeLocationOffset = GetDesignerSettings()->RelativeLocationOffset;
-	if (GetDesignerSettings()->bScaleRelativeLocationOffset)
+	if (IsValid(ControlledSpawnedActor))
 	{
-		RelativeLocationOffset *= NewScale;
+		ApplyActorTransform(ControlledSpawnedActor, ComposeSpawnActorTransform(GetSpawnActorRotation().Quaternion(), NewScale));
 	}
+}
 
-	FVector WorldLocationOffset = GetDesignerSettings()->WorldLocationOffset;
-	if (GetDesignerSettings()->bScaleWorldLocationOffset)
+FTransform FSpawnAssetTool::ComposeSpawnActorTransform(const FQuat& Rotation, const FVector& Scale) const
+{
+	FVector RelativeLocationOffset = GetSpawnSettings()->RelativeLocationOffset;
+	if (GetSpawnSettings()->bScaleRelativeLocationOffset)
 	{
-		WorldLocationOffset *= NewScale;
+		RelativeLocationOffset *= Scale;
 	}
 
-	WorldLocationOffset += TraceNormal * ActorScrollWheelOffset * DefaultSpawnedActorExtent * 0.05F;
-
-	if (IsValid(ControlledSpawnedActor))
+	FVector WorldLocationOffset = GetSpawnSettings()->WorldLocationOffset;
+	if (GetSpawnSettings()->bScaleWorldLocationOffset)
 	{
-		ControlledSpawnedActor->SetActorTransform(NewSpawnedActorTransform);
-		ControlledSpawnedActor->AddActorLocalOffset(RelativeLocationOffset);
-		ControlledSpawnedActor->AddActorWorldOffset(WorldLocationOffset);
+		WorldLocationOffset *= Scale;
 	}
+
+	WorldLocationOffset += TraceNormal * ActorScrollWheelOffset * DefaultSpawnedActorExtent * GetSpawnSettings()->ScrollWheelOffsetScale;
+
+	// The relative offset is rotated but not scaled by the actor, the same as AddActorLocalOffset.
+	return FTransform(Rotation, SpawnWorldTransform.GetLocation() + Rotation.RotateVector(RelativeLocationOffset) + WorldLocationOffset, Scale);
+}
+
+void FSpawnAssetTool::ApplyActorTransform(AActor* Actor, const FTransform& Transform)
+{
+	if (Actor == nullptr || Actor->GetRootComponent() == nullptr)
+		return;
+
+	// The transforms, bounds and render state of the attached components are updated once when the scope ends.
+	FScopedMovementUpdate ScopedMovementUpdate(Actor->GetRootComponent(), EScopedUpdate::DeferredUpdates);
+	Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::TeleportPhysics);
 }
 
 void FSpawnAssetTool::RegenerateRandomRotationOffset()
 {
-	GetDesignerSettings()->RandomRotation.RegenerateRandomValue();
+	GetSpawnSettings()->RandomRotation.RegenerateRandomValue();
 }
 
 FRotator FSpawnAssetTool::GetRandomRotationOffset() const
 {
 	return FRotator( // Pitch, Yaw, Roll = Y, Z, X.
-		GetDesignerSettings()->RandomRotation.Y.GetCurrentRandomValue(),
-		GetDesignerSettings()->RandomRotation.Z.GetCurrentRandomValue(),
-		GetDesignerSettings()->RandomRotation.X.GetCurrentRandomValue()
+		GetSpawnSettings()->RandomRotation.Y.GetCurrentRandomValue(),
+		GetSpawnSettings()->RandomRotation.Z.GetCurrentRandomValue(),
+		GetSpawnSettings()->RandomRotation.X.GetCurrentRandomValue()
 	);
 }
 
 void FSpawnAssetTool::RegenerateRandomScale()
 {
-	GetDesignerSettings()->RandomScale.RegenerateRandomValue();
+	GetSpawnSettings()->RandomScale.RegenerateRandomValue();
 }
 
 FVector FSpawnAssetTool::GetSpawnActorScale() const
 {
-	return DesignerSettings->GetScale();
+	return GetSpawnSettings()->GetScale();
 }
 
 FRotator FSpawnAssetTool::GetSpawnActorRotation()
@@ -917,7 +2167,7 @@ FRotator FSpawnAssetTool::GetSpawnActorRotation()
 	if (MouseDirection.IsNearlyZero())
 		MouseDirection = SpawnWorldTransform.GetRotation().GetForwardVector();
 
-	FVector ForwardVector = GetDesignerSettings()->AxisToAlignWithCursor == EAxisType::None ? SpawnWorldTransform.GetRotation().GetForwardVector() : MouseDirection;
+	FVector ForwardVector = GetSpawnSettings()->AxisToAlignWithCursor == EAxisType::None ? SpawnWorldTransform.GetRotation().GetForwardVector() : MouseDirection;
 	FVector UpVector = SpawnWorldTransform.GetRotation().GetUpVector();
 
 	// if they're almost same, we need to find arbitrary vector
@@ -934,7 +2184,7 @@ FRotator FSpawnAssetTool::GetSpawnActorRotation()
 	FVector SwizzledRightVector = FVector::ZeroVector;
 	FVector SwizzledUpVector = FVector::ZeroVector;
 
-	switch (GetDesignerSettings()->AxisToAlignWithNormal)
+	switch (GetSpawnSettings()->AxisToAlignWithNormal)
 	{
 	case EAxisType::Forward:
 		SwizzledForwardVector = UpVector;
@@ -956,7 +2206,7 @@ FRotator FSpawnAssetTool::GetSpawnActorRotation()
 		break;
 	}
 
-	switch (GetDesignerSettings()->AxisToAlignWithCursor)
+	switch (GetSpawnSettings()->AxisToAlignWithCursor)
 	{
 	case EAxisType::Backward:
 		SwizzledForwardVector = -ForwardVector;
@@ -1003,7 +2253,7 @@ FRotator FSpawnAssetTool::GetSpawnActorRotation()
 	}
 
 	// Apply the generated random rotation offset if the user has set the bApplyRandomRotation setting
-	if (GetDesignerSettings()->bApplyRandomRotation)
+	if (GetSpawnSettings()->bApplyRandomRotation)
 	{
 		DesignerActorRotation = FRotator(DesignerActorRotation.Quaternion() * GetRandomRotationOffset().Quaternion());
 	}
@@ -1011,9 +2261,9 @@ FRotator FSpawnAssetTool::GetSpawnActorRotation()
 	// Snap the axes to the grid if the user has set bSnapToGridRotation
 	FRotator SpawnRotationSnapped = DesignerActorRotation;
 	FSnappingUtils::SnapRotatorToGrid(SpawnRotationSnapped);
-	DesignerActorRotation.Roll = GetDesignerSettings()->SnapRotationToGrid.X ? SpawnRotationSnapped.Roll : DesignerActorRotation.Roll;
-	DesignerActorRotation.Pitch = GetDesignerSettings()->SnapRotationToGrid.Y ? SpawnRotationSnapped.Pitch : DesignerActorRotation.Pitch;
-	DesignerActorRotation.Yaw = GetDesignerSettings()->SnapRotationToGrid.Z ? SpawnRotationSnapped.Yaw : DesignerActorRotation.Yaw;
+	DesignerActorRotation.Roll = GetSpawnSettings()->SnapRotationToGrid.X ? SpawnRotationSnapped.Roll : DesignerActorRotation.Roll;
+	DesignerActorRotation.Pitch = GetSpawnSettings()->SnapRotationToGrid.Y ? SpawnRotationSnapped.Pitch : DesignerActorRotation.Pitch;
+	DesignerActorRotation.Yaw = GetSpawnSettings()->SnapRotationToGrid.Z ? SpawnRotationSnapped.Yaw : DesignerActorRotation.Yaw;
 
 	return DesignerActorRotation;
 }
@@ -1040,8 +2290,64 @@ void FSpawnAssetTool::UnregisterSpawnPlane()
 	}
 }
 
+void FSpawnAssetTool::SuspendControlledActorUpdates()
+{
+	if (!DesignerSettings->bDeferControlledActorUpdates || !IsValid(ControlledSpawnedActor) || bIsControlledActorSuspended)
+		return;
+
+	bIsControlledActorSuspended = true;
+
+	bControlledActorEnableCollision = ControlledSpawnedActor->GetActorEnableCollision();
+	ControlledSpawnedActor->SetActorEnableCollision(false);
+
+	TInlineComponentArray<UPrimitiveComponent*> PrimitiveComponents(ControlledSpawnedActor);
+	for (UPrimitiveComponent* PrimitiveComponent : PrimitiveComponents)
+	{
+		SuspendedComponentUpdates.Add({ PrimitiveComponent, PrimitiveComponent->CanEverAffectNavigation(), PrimitiveComponent->GetGenerateOverlapEvents() });
+
+		PrimitiveComponent->SetCanEverAffectNavigation(false);
+		PrimitiveComponent->SetGenerateOverlapEvents(false);
+	}
+}
+
+void FSpawnAssetTool::ResumeControlledActorUpdates()
+{
+	if (!bIsControlledActorSuspended)
+		return;
+
+	bIsControlledActorSuspended = false;
+
+	bool bGenerateOverlapEvents = false;
+	for (const FSuspendedComponentUpdates& SuspendedComponent : SuspendedComponentUpdates)
+	{
+		if (UPrimitiveComponent* PrimitiveComponent = SuspendedComponent.Component.Get())
+		{
+			PrimitiveComponent->SetGenerateOverlapEvents(SuspendedComponent.bGenerateOverlapEvents);
+			PrimitiveComponent->SetCanEverAffectNavigation(SuspendedComponent.bCanEverAffectNavigation);
+			bGenerateOverlapEvents |= SuspendedComponent.bGenerateOverlapEvents;
+		}
+	}
+
+	SuspendedComponentUpdates.Reset();
+
+	if (!IsValid(ControlledSpawnedActor))
+		return;
+
+	ControlledSpawnedActor->SetActorEnableCollision(bControlledActorEnableCollision);
+
+	// The single notification of the finished move, which updates the physics state and the navigation around the final location.
+	ControlledSpawnedActor->PostEditMove(true);
+
+	if (bGenerateOverlapEvents)
+	{
+		ControlledSpawnedActor->UpdateOverlaps();
+	}
+}
+
 void FSpawnAssetTool::ReleaseControlledActor()
 {
+	ResumeControlledActorUpdates();
+
 	if (IsValid(ControlledSpawnedActor))
 	{
 		ReleasedSpawnedActor = ControlledSpawnedActor;
@@ -1049,4 +2355,78 @@ void FSpawnAssetTool::ReleaseControlledActor()
 	}
 }
 
+namespace
+{
+	/**
+	 * Compare moving an actor with a deep component hierarchy with a transform and two offsets against a single composed transform.
+	 * Usage: Designer.BenchmarkActorTransform [HierarchyDepth] [Iterations]
+	 */
+	void BenchmarkActorTransform(const TArray<FString>& Args)
+	{
+		UWorld* World = GEditor != nullptr ? GEditor->GetEditorWorldContext().World() : nullptr;
+		if (World == nullptr)
+			return;
+
+		const int32 HierarchyDepth = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 32;
+		const int32 Iterations = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 1000;
+
+		TGuardValue<ITransaction*> DisableUndo(GUndo, nullptr);
+
+		FActorSpawnParameters ActorSpawnParameters;
+		ActorSpawnParameters.ObjectFlags = RF_Transient;
+		ActorSpawnParameters.bTemporaryEditorActor = true;
+		ActorSpawnParameters.bHideFromSceneOutliner = true;
+		AActor* Actor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, ActorSpawnParameters);
+		if (Actor == nullptr)
+			return;
+
+		USceneComponent* ParentComponent = NewObject<USceneComponent>(Actor, TEXT("Root"));
+		ParentComponent->SetMobility(EComponentMobility::Movable);
+		Actor->SetRootComponent(ParentComponent);
+		ParentComponent->RegisterComponent();
+
+		for (int32 Depth = 0; Depth < HierarchyDepth; Depth++)
+		{
+			UStaticMeshComponent* ChildComponent = NewObject<UStaticMeshComponent>(Actor);
+			ChildComponent->SetMobility(EComponentMobility::Movable);
+			ChildComponent->SetupAttachment(ParentComponent);
+			ChildComponent->SetRelativeLocation(FVector(10.F, 0.F, 0.F));
+			ChildComponent->RegisterComponent();
+			ParentComponent = ChildComponent;
+		}
+
+		const FVector RelativeLocationOffset(0.F, 0.F, 50.F);
+		const FVector WorldLocationOffset(0.F, 25.F, 0.F);
+
+		const double OffsetsStartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			const FTransform Transform(FRotator(0.F, Iteration, 0.F), FVector(Iteration, 0.F, 0.F));
+			Actor->SetActorTransform(Transform);
+			Actor->AddActorLocalOffset(RelativeLocationOffset);
+			Actor->AddActorWorldOffset(WorldLocationOffset);
+		}
+		const double OffsetsTime = FPlatformTime::Seconds() - OffsetsStartTime;
+
+		const double ComposedStartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			const FQuat Rotation = FRotator(0.F, Iteration, 0.F).Quaternion();
+			FSpawnAssetTool::ApplyActorTransform(Actor, FTransform(Rotation, FVector(Iteration, 0.F, 0.F) + Rotation.RotateVector(RelativeLocationOffset) + WorldLocationOffset));
+		}
+		const double ComposedTime = FPlatformTime::Seconds() - ComposedStartTime;
+
+		World->DestroyActor(Actor, false, false);
+
+		UE_LOG(LogDesigner, Log, TEXT("BenchmarkActorTransform: %d moves of an actor with %d attached components."), Iterations, HierarchyDepth);
+		UE_LOG(LogDesigner, Log, TEXT("BenchmarkActorTransform: Transform and offsets %.3f us per move."), OffsetsTime * 1000000.0 / Iterations);
+		UE_LOG(LogDesigner, Log, TEXT("BenchmarkActorTransform: Composed transform %.3f us per move."), ComposedTime * 1000000.0 / Iterations);
+	}
+
+	FAutoConsoleCommand BenchmarkActorTransformCommand(
+		TEXT("Designer.BenchmarkActorTransform"),
+		TEXT("Compare moving an actor with a transform and offsets against a single composed transform. Args: [HierarchyDepth] [Iterations]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkActorTransform));
+}
+
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
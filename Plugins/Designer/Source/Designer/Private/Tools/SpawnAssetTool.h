@@ -26,11 +26,29 @@
 
 #include "CoreMinimal.h"
 #include "Tools/DesignerTool.h"
+#include "Tools/PlaceableAssetIndex.h"
+#include "Tools/PlaceableAssetSelection.h"
+#include "Tools/AssetResidencyCache.h"
+#include "Tools/AssetExtentCache.h"
+#include "Tools/PreviewActorPool.h"
+#include "Tools/BlueprintPreviewCache.h"
+#include "Tools/ViewportViewCache.h"
+#include "Tools/PlacementTraceCache.h"
+#include "Tools/PlacementTrace.h"
+#include "Tools/StaticGeometryBVH.h"
+#include "Tools/LandscapeHeightfieldCache.h"
 #include "UObject/GCObject.h"
+#include "Engine/StreamableManager.h"
+#include "WorldCollision.h"
+#include "ShowFlags.h"
 
 class AActor;
+class UDesignerPalette;
 class UDesignerSettings;
+struct FDesignerPaletteEntry;
+struct FStreamableHandle;
 class UMaterialInstanceDynamic;
+class UStaticMesh;
 class UStaticMeshComponent;
 
 /**
@@ -49,12 +67,34 @@ private:
 
 	UMaterialInterface* PreviewActorPulsingMaterial;
 
+	/** The number of material slots of every primitive component of the actor spawned for an asset, in component order, per asset object path */
+	TMap<FName, TArray<int32>> MaterialSlotLayouts;
+
 	/** The static mesh of the Spawn visualizer component */
 	UStaticMeshComponent* SpawnPlaneComponent;
 
+	/** Renders the preview of static mesh assets, so no preview actor has to be spawned for them */
+	UStaticMeshComponent* MeshPreviewComponent;
+
 	/** The material instance dynamic of the Spawn visualizer component */
 	UMaterialInstanceDynamic* SpawnVisualizerMID;
 
+	/** The indices of the spawn visualizer parameters, so the parameters are set without looking up their names */
+	int32 CursorInputDownWorldLocationParameterIndex;
+
+	int32 CursorPlaneWorldLocationParameterIndex;
+
+	int32 ForwardAxisColorParameterIndex;
+
+	/** The last forward axis color, it only changes with the settings */
+	FLinearColor SpawnVisualizerForwardAxisColor;
+
+	/** The width of the spawn visualizer plane mesh at scale 1 */
+	float SpawnPlaneMeshSize;
+
+	/** The radius around the spawn location covered by the spawn visualizer plane, the plane grows when the cursor is dragged beyond it */
+	float SpawnPlaneCoveredRadius;
+
 	/** The plane we trace against when transforming the placed actor */
 	FPlane SpawnTracePlane;
 
@@ -79,23 +119,228 @@ private:
 	/** The actor currently controlled by the designer editor mode */
 	AActor* ControlledSpawnedActor;
 
+	/** The navigation and overlap flags of a component of the controlled actor, which are restored when it is released */
+	struct FSuspendedComponentUpdates
+	{
+		TWeakObjectPtr<UPrimitiveComponent> Component;
+
+		bool bCanEverAffectNavigation;
+
+		bool bGenerateOverlapEvents;
+	};
+
+	TArray<FSuspendedComponentUpdates> SuspendedComponentUpdates;
+
+	/** True while the collision, navigation and overlap updates of the controlled actor are suspended */
+	bool bIsControlledActorSuspended;
+
+	/** The collision of the controlled actor before it was suspended */
+	bool bControlledActorEnableCollision;
+
 	/** The last spawned actor released by the tool, so not in control anymore */
 	AActor* ReleasedSpawnedActor;
 
+	/** True while a preview actor is spawned, so the level actor added event of the preview is ignored */
+	bool bIsSpawningPreviewActor;
+
 	/** The local box extent of the selected designer actor in cm when scale is uniform 1 */
 	FVector DefaultSpawnedActorExtent;
 	
 	FVector SpawnedActorScale;
 	/** The local box extent of the selected designer actor in cm when scale is uniform 1 */
 
-	/** The array of assets which is selected in the content browser and is actually placeable */
-	TArray<FAssetData> PlaceableSelectedAssets;
+	/** Decides which assets are placeable without loading them */
+	FPlaceableAssetIndex PlaceableAssetIndex;
+
+	/** The assets which are selected in the content browser and are actually placeable, updated when the content browser selection changes */
+	FPlaceableAssetSelection PlaceableSelectedAssets;
 
 	/** The asset which should be spawned and is currently being previewed */
 	FAssetData TargetAssetDataToSpawn;
 
 	TArray<AActor*> PreviousSelection;
 
+	/** Streams in the target asset so the game thread is never blocked while it loads */
+	FStreamableManager StreamableManager;
+
+	/** Keeps the target asset loaded while it is being streamed in and spawned */
+	TSharedPtr<FStreamableHandle> TargetAssetStreamingHandle;
+
+	/** The loaded target asset, null while the target asset is still streaming in. Referenced so it can't be collected while it is the target, also when it was already loaded. */
+	UObject* LoadedTargetAsset;
+
+	/** The actor factory used to spawn the target asset */
+	UActorFactory* TargetActorFactory;
+
+	/** Persistent cache of asset extents so the bounds are known before the asset is spawned */
+	FAssetExtentCache ExtentCache;
+
+	/** The palette entry the target asset was picked from or INDEX_NONE when picked from the content browser selection */
+	int32 TargetPaletteEntryIndex;
+
+	/** The designer settings with the overrides of the target palette entry applied */
+	UDesignerSettings* PaletteEntrySettings;
+
+	/** The settings used to spawn the target asset, either the user settings or the palette entry settings */
+	UDesignerSettings* SpawnSettings;
+
+	/** The next asset to spawn, prepared while the current actor is dragged so releasing the mouse only has to swap it in */
+	struct FPrewarmedTarget
+	{
+		FAssetData AssetData;
+
+		int32 PaletteEntryIndex = INDEX_NONE;
+
+		TSharedPtr<FStreamableHandle> StreamingHandle;
+
+		/** Referenced so the asset can't be collected while it is prewarmed */
+		UObject* Asset = nullptr;
+
+		UActorFactory* ActorFactory = nullptr;
+
+		FVector Extent = FVector::ZeroVector;
+
+		bool bHasExtent = false;
+
+		/** The hidden preview actor which becomes visible when swapped in */
+		AActor* PreviewActor = nullptr;
+
+		/** True if the asset is previewed by components owned by the tool instead of a preview actor */
+		bool bUsesComponentPreview = false;
+
+		FORCEINLINE bool IsReady() const { return (PreviewActor != nullptr || bUsesComponentPreview) && bHasExtent; }
+	};
+
+	FPrewarmedTarget PrewarmedTarget;
+
+	/** The last frame a prewarm step was done, so only a single step is done per frame */
+	uint64 LastPrewarmFrameCounter;
+
+	/** Keeps recently placed assets loaded so they are not loaded again when picked again */
+	FAssetResidencyCache ResidencyCache;
+
+	/** Keeps preview actors hidden instead of destroying them, so they are shown again when the same asset is previewed */
+	FPreviewActorPool PreviewActorPool;
+
+	/** Render only previews of blueprints built from their component templates, so no construction script runs for a preview */
+	FBlueprintPreviewCache BlueprintPreviews;
+
+	/** The scene views the cursor is traced in, so no view family is allocated for every mouse move */
+	FViewportViewCache ViewportViews;
+
+	/** The last placement trace, reused while the cursor ray and the world along it don't change */
+	FPlacementTraceCache PlacementTraces;
+
+	/** The triangles of the static meshes in the level, which can be traced from any thread without the physics scene */
+	FStaticGeometryBVH StaticGeometry;
+
+	/** The landscape heights, so the cursor is placed on the landscape without tracing the physics scene */
+	FLandscapeHeightfieldCache LandscapeHeightfields;
+
+	/** The number of cursor rays placed on the landscape heightfield */
+	uint32 LandscapeHeightfieldHitCount;
+
+	/** The number of cursor rays which hit something in front of the landscape and were traced in the physics scene instead */
+	uint32 LandscapeHeightfieldFallbackCount;
+
+	/** The hit location and normal of the last estimated surface normal, it is reused while the hit doesn't change */
+	FVector LastEstimatedNormalLocation;
+
+	FVector LastEstimatedNormalSurfaceNormal;
+
+	FVector LastEstimatedNormal;
+
+	/** The hit whose surface normal waits for sample rays traced in the physics scene, they complete the estimate on a following tick */
+	FActorPositionTraceResult SurfaceNormalTraceResult;
+
+	/** The samples of the pending estimate which are known so far, in order around the hit */
+	TArray<FStaticGeometryHit, TInlineAllocator<32>> SurfaceNormalSampleHits;
+
+	/** One handle per sample, only valid for the samples traced in the physics scene */
+	TArray<FTraceHandle, TInlineAllocator<32>> SurfaceNormalTraceHandles;
+
+	TWeakObjectPtr<UWorld> SurfaceNormalTraceWorld;
+
+	/** The frame in which the sample traces were submitted */
+	uint64 SurfaceNormalTraceFrameCounter;
+
+	/** The normal fitted to the samples which were known without the physics scene, used until the sample traces complete */
+	FVector ProvisionalEstimatedNormal;
+
+	/** The world transform of the bounds proxy which is drawn while the target asset is still streaming in */
+	FTransform PreviewWorldTransform;
+
+	/** True if the user clicked to spawn while the target asset was still streaming in */
+	bool bHasPendingSpawn;
+
+	/** True if the mouse button of the pending spawn is already released, so the actor should be placed right after spawning */
+	bool bIsPendingSpawnReleased;
+
+	/** The spawn transform at the moment the user clicked for the pending spawn */
+	FTransform PendingSpawnWorldTransform;
+
+	/** The viewport client which received the click for the pending spawn */
+	FEditorViewportClient* PendingSpawnViewportClient;
+
+	/** The viewport client which received the latest mouse move, the move is applied once per frame when this viewport ticks */
+	FEditorViewportClient* PendingMouseMoveViewportClient;
+
+	/** True if the latest mouse move was captured while dragging the spawned actor */
+	bool bIsPendingMouseMoveCaptured;
+
+	/** The number of mouse moves which were replaced by a later mouse move in the same frame */
+	uint32 CoalescedMouseMoveCount;
+
+	/** Everything the tool draws in the viewport, the viewport is only redrawn when this changes */
+	struct FViewportRedrawState
+	{
+		bool bIsToolActive = false;
+		bool bIsTargetAssetReady = false;
+		bool bIsComponentPreviewShown = false;
+		bool bIsPreviewActorShown = false;
+		bool bIsSpawnPlaneRegistered = false;
+		const AActor* PreviewActor = nullptr;
+		FTransform PreviewWorldTransform;
+		FTransform ControlledActorTransform;
+		FVector CursorPlaneIntersectionWorldLocation = FVector::ZeroVector;
+		FVector SpawnedActorScale = FVector::OneVector;
+		FLinearColor SpawnVisualizerForwardAxisColor = FLinearColor::Transparent;
+
+		bool Equals(const FViewportRedrawState& Other) const;
+	};
+
+	/** The state of the tool the last time the viewport was redrawn */
+	FViewportRedrawState LastViewportRedrawState;
+
+	/** The viewport client under the cursor, the only viewport which is redrawn for the tool */
+	FEditorViewportClient* CursorViewportClient;
+
+	/** The number of times the viewport under the cursor was redrawn because the tool state changed */
+	uint32 ViewportInvalidationCount;
+
+	/** The latest async hover trace, its result is applied on the next tick. Earlier traces are dropped. */
+	FTraceHandle AsyncTraceHandle;
+
+	/** The world the async hover trace was submitted to */
+	TWeakObjectPtr<UWorld> AsyncTraceWorld;
+
+	/** The viewport client which submitted the async hover trace */
+	FEditorViewportClient* AsyncTraceViewportClient;
+
+	/** The frame in which the async hover trace was submitted */
+	uint64 AsyncTraceFrameCounter;
+
+	/** The cursor ray of the async hover trace, its result is stored in the placement trace cache for this ray */
+	FVector AsyncTraceOrigin;
+
+	FVector AsyncTraceDirection;
+
+	/** The show flags of the view the async hover trace was submitted from, the hit is filtered the same as the synchronous trace */
+	TOptional<FEngineShowFlags> AsyncTraceShowFlags;
+
+	/** The number of async hover traces which were replaced by a later trace before their result was applied */
+	uint32 DroppedAsyncTraceCount;
+
 public:
 	FSpawnAssetTool(UDesignerSettings* DesignerSettings);
 
@@ -166,37 +411,215 @@ public:
 
 	virtual bool FrustumSelect(const FConvexVolume& InFrustum, FEditorViewportClient* InViewportClient, bool InSelect = true);
 
+	/** Applies the latest mouse move and prepares the next asset to spawn during idle frames */
+	virtual void Tick(FEditorViewportClient* ViewportClient, float DeltaTime);
+
+	/** Draws the bounds proxy of the target asset while it is still streaming in */
+	virtual void Render(const FSceneView* View, FViewport* Viewport, FPrimitiveDrawInterface* PDI);
+
 	/** The settings available to the user */
 	FORCEINLINE UDesignerSettings* GetDesignerSettings() const { return DesignerSettings; }
 
 	/** The actor currently controlled by the designer editor mode */
 	FORCEINLINE TWeakObjectPtr<AActor> GetControlledActor() const { return ControlledSpawnedActor; }
 
+	/** The cache keeping recently placed assets loaded */
+	FORCEINLINE const FAssetResidencyCache& GetResidencyCache() const { return ResidencyCache; }
+
+	FORCEINLINE const FPreviewActorPool& GetPreviewActorPool() const { return PreviewActorPool; }
+
+	/** Move the actor with a single deferred update of its component hierarchy, teleporting its physics */
+	static void ApplyActorTransform(AActor* Actor, const FTransform& Transform);
+
 private:
 	virtual void SetToolActive(bool NewIsActive) override;
 
-	void SetAllMaterialsForActor(AActor* Actor, UMaterialInterface* Material);
+	void SetAllMaterialsForActor(AActor* Actor, const FAssetData& AssetData, UMaterialInterface* Material);
+
+	/**
+	 * The material slot count of every primitive component of the actor spawned for the asset, cached per asset.
+	 * Not per actor class, since the factory actor classes like the static mesh actor are shared by assets with a different number of slots.
+	 */
+	const TArray<int32>& GetMaterialSlotLayout(const FAssetData& AssetData, TArrayView<UPrimitiveComponent*> PrimitiveComponents);
 
 	/** Create all preview actors */
 	void RefreshPreviewActors();
 
-	/** Destroy all preview actors */
+	/** Hide all preview actors and return them to the pool */
 	void DestroyPreviewActors();
 
-	/** Non transactional version of UEditorEngine::UseActorFactory */
+	/** Show a pooled preview actor of the asset or spawn a new one with the preview material */
+	AActor* AcquirePreviewActor(UActorFactory* Factory, const FAssetData& AssetData);
+
+	/** The static mesh to show with the mesh preview component, or null if the asset needs a preview actor */
+	UStaticMesh* GetPreviewStaticMesh(UObject* Asset, UActorFactory* ActorFactory) const;
+
+	/** The blueprint class to show with a cached blueprint preview, or null if the asset needs a preview actor */
+	const UClass* GetPreviewBlueprintClass(UObject* Asset, UActorFactory* ActorFactory) const;
+
+	/** True if the asset can be previewed without a preview actor. Builds the cached blueprint preview if needed. */
+	bool PrepareComponentPreview(UObject* Asset, UActorFactory* ActorFactory);
+
+	/** Show the preview of the asset with components owned by the tool. Returns false if the asset needs a preview actor. */
+	bool ShowComponentPreview(UObject* Asset, UActorFactory* ActorFactory);
+
+	/** True if the mesh preview component or a blueprint preview is registered */
+	bool IsComponentPreviewShown() const;
+
+	/** Register the mesh preview component showing the static mesh with the preview material */
+	void ShowMeshPreview(UStaticMesh* StaticMesh);
+
+	/** Unregister the mesh preview component, so it has no render state while it isn't used */
+	void HideMeshPreview();
+
+	/** Non transactional version of UEditorEngine::UseActorFactory, which spawns a transient preview actor that is hidden from the outliner and never dirties the level */
 	AActor* SpawnPreviewActorFromFactory(UActorFactory* Factory, const FAssetData& AssetData, const FTransform* InActorTransform, EObjectFlags InObjectFlags);
 
-	/** Clears the PlaceableSelectedAssets array and fills it again with the placeable assets currently selected in the content browser */
+	/** Picks a new random asset to spawn from the placeable selected assets and starts streaming it in */
 	void RefreshPlaceableAsset();
 
-	/** Helper function to see if asset data can be placed in the world */
-	bool IsAssetDataPlaceable(FAssetData AssetData);
+	/**
+	 * Pick a random asset from the palette by weight or otherwise from the placeable selected assets, different from the excluded asset if possible.
+	 * Returns false if there is nothing to pick from.
+	 */
+	bool PickTarget(const FAssetData& ExcludedAssetData, FAssetData& OutAssetData, int32& OutPaletteEntryIndex);
+
+	/** Use the settings with the overrides of the target palette entry applied, or the user settings otherwise */
+	void ApplyPaletteEntrySettings();
+
+	/** Find the extent of an asset without spawning it, either baked in the palette entry or cached on disk */
+	bool FindKnownExtent(const FAssetData& AssetData, int32 PaletteEntryIndex, FVector& OutExtent) const;
+
+	/** Pick the next asset to spawn and start preparing it */
+	void BeginPrewarm();
+
+	/** Do a single preparation step of the next asset: resolve the factory, find the extent or spawn the hidden preview */
+	void TickPrewarm();
+
+	/** Make the prepared asset the target asset and show its preview. Returns false if it isn't ready or can't be picked anymore. */
+	bool SwapInPrewarmedTarget();
+
+	/** Stop preparing the next asset and destroy its hidden preview */
+	void CancelPrewarm();
+
+	/** The palette entry the target asset was picked from, null if it was picked from the content browser selection */
+	const FDesignerPaletteEntry* GetTargetPaletteEntry() const;
+
+	/** Store the extent of the target asset, baked for palette entries, cached on disk or otherwise calculated from the spawned actor */
+	void UpdateTargetExtent(AActor* SpawnedActor);
+
+	/** Calculate the extents of the selected assets in the background */
+	void OnPlaceableSelectionChanged();
+
+	/** Rebuild the blueprint template previews, a recompiled blueprint keeps its class so the cached previews would be outdated */
+	void OnBlueprintCompiled();
+
+	/** Undo and redo change actors without the level actor events, so the caches built from the level are checked again */
+	void OnUndoRedo();
+
+	/** Reinstancing replaces components without the level actor events, so the caches built from the level are checked again */
+	void OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacementMap);
+
+	/** Invalidate the cached placement trace when an actor is added, moved or removed along it. The preview actors of the tool are ignored. */
+	void OnLevelActorChanged(AActor* Actor);
+
+	/** The settings used to spawn the target asset, with the palette entry overrides applied */
+	FORCEINLINE UDesignerSettings* GetSpawnSettings() const { return SpawnSettings; }
+
+	/** Request the target asset through the streamable manager. The preview actors are refreshed once it is loaded. */
+	void RequestTargetAsset();
+
+	/** Called when the target asset is loaded, replaces the bounds proxy with the real preview and applies a pending spawn */
+	void OnTargetAssetLoaded();
+
+	/** True if the target asset is loaded and can be spawned without blocking */
+	FORCEINLINE bool IsTargetAssetReady() const { return IsValid(LoadedTargetAsset) && TargetActorFactory != nullptr; }
+
+	/** The local extent of the asset read from the asset registry tags, used before the asset is loaded */
+	static FVector GetAssetRegistryExtent(const FAssetData& AssetData);
+
+	/** Spawn the target asset at the spawn world transform and take control over it. Returns true if an actor was spawned. */
+	bool SpawnControlledActor(FEditorViewportClient* ViewportClient);
+
+	/** Disable collision, navigation relevance and overlap events of the controlled actor, so moving it doesn't update them while it is dragged */
+	void SuspendControlledActorUpdates();
+
+	/** Restore what was suspended and update the collision, navigation and overlaps of the controlled actor once */
+	void ResumeControlledActorUpdates();
+
+	/** Release the controlled actor and prepare the next asset to spawn */
+	void CompletePlacement();
+
+	/** Forget about the spawn which was requested while the target asset was still streaming in */
+	void ClearPendingSpawn();
+
+	/** Remember the mouse move so it is applied on the next tick, replacing the previous mouse move of this frame */
+	void QueueMouseMove(FEditorViewportClient* ViewportClient, bool bIsCaptured);
+
+	/** Trace and update the transforms for the latest mouse move */
+	void FlushPendingMouseMove();
+
+	FORCEINLINE void ClearPendingMouseMove() { PendingMouseMoveViewportClient = nullptr; }
+
+	/** Forget the viewport clients which were closed since the tool remembered them, the modes aren't notified when a viewport is closed */
+	void ClearClosedViewportClients();
+
+	/** Returns true if the viewport client is still one of the editor viewport clients */
+	static bool IsViewportClientOpen(const FEditorViewportClient* ViewportClient);
+
+	/** Gather everything the tool draws in the viewport */
+	FViewportRedrawState GetViewportRedrawState() const;
+
+	/** Redraw the viewport under the cursor if the preview, the spawned actor or the spawn visualizer changed since the last redraw */
+	void InvalidateViewportIfChanged(FEditorViewportClient* ViewportClient);
+
+	/** Trace the cursor through the async trace API of the world, replacing the previous async trace. The result is applied by TickAsyncSpawnTrace. */
+	void RequestAsyncSpawnTrace(FEditorViewportClient* ViewportClient, FViewport* Viewport);
+
+	/** Apply the result of the async hover trace once it completed */
+	void TickAsyncSpawnTrace(FEditorViewportClient* ViewportClient);
+
+	/** Drop the async hover trace, its result is never applied */
+	FORCEINLINE void CancelAsyncSpawnTrace() { AsyncTraceHandle.Invalidate(); AsyncTraceViewportClient = nullptr; }
+
+	/**
+	 * Convert the result of the async hover trace like the synchronous trace does.
+	 * The async trace only returns the first blocking hit, when it is on something invisible the ray is traced again synchronously past it.
+	 */
+	FActorPositionTraceResult MakeTraceResult(const UWorld* World, const FTraceDatum& TraceDatum) const;
 
 	/** Update the material parameters for the spawn visualizer component. Returns true if it was successful */
 	bool UpdateSpawnVisualizerMaterialParameters();
 
+	/** Scale the spawn visualizer plane so it covers the drag radius instead of the whole level */
+	void UpdateSpawnPlaneBounds(float DragRadius);
+
 	/** Calculate the world transform for the mouse and store it in MouseDownWorldTransform. Returns true if it was successful */
 	bool RecalculateSpawnTransform(FEditorViewportClient* ViewportClient, FViewport* Viewport);
+
+	/** Intersect the cursor ray with the landscape heightfields. Returns false if nothing was hit or something is in front of the landscape. */
+	bool TraceLandscapeForPosition(const UWorld* World, const FVector& RayOrigin, const FVector& RayDirection, const FEngineShowFlags& ShowFlags, FActorPositionTraceResult& OutResult);
+
+	/**
+	 * Sample the surface in a circle around the hit and fit a plane to the samples, returns the normal of the plane.
+	 * Static meshes and landscapes are sampled without the physics scene. The other samples are traced async, until they complete the normal of the known samples is returned.
+	 */
+	FVector EstimateSurfaceNormal(UWorld* World, const FActorPositionTraceResult& TraceResult);
+
+	/** Complete the pending surface normal estimate once its sample traces are done, and apply it to the preview if the hover didn't move */
+	void TickSurfaceNormalTraces();
+
+	/** Drop the pending surface normal estimate, the results of its sample traces are never used */
+	FORCEINLINE void CancelSurfaceNormalTraces() { SurfaceNormalTraceHandles.Reset(); }
+
+	/** Newell's method over the fan of triangles between the hit and the samples which hit something, which are in order around it */
+	static FVector FitSurfaceNormal(const FVector& Center, const FVector& HitNormal, TArrayView<const FStaticGeometryHit> Hits);
+
+	/** Calculate the spawn transform from the result of a trace in the world. Returns false if nothing was hit. */
+	bool ApplySpawnTraceResult(UWorld* World, const FActorPositionTraceResult& TraceResult);
+
+	/** Move the preview to the hover trace result */
+	void ApplyHoverTraceResult(UWorld* World, const FActorPositionTraceResult& TraceResult);
 	
 	/** Recalculate the world transform of the mouse and store it in the CurrentMouseWorldTransform. Returns true if it was successful */
 	void RecalculateMousePlaneIntersectionWorldLocation(FEditorViewportClient* ViewportClient, FViewport* Viewport);
@@ -222,6 +645,9 @@ private:
 	/** Get the designer actor rotation with all settings applied to it */
 	FRotator GetSpawnActorRotation();
 
+	/** The final actor transform at the spawn location, with the relative and world location offsets applied */
+	FTransform ComposeSpawnActorTransform(const FQuat& Rotation, const FVector& Scale) const;
+
 	/** Change the visibility of the spawn plane to be visible. */
 	void RegisterSpawnPlane(FEditorViewportClient* InViewportClient);
 	
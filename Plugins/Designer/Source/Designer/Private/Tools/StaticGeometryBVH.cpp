@@ -0,0 +1,860 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "StaticGeometryBVH.h"
+#include "DesignerModule.h"
+
+#include "Algo/Sort.h"
+#include "Async/ParallelFor.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/Level.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Actor.h"
+#include "LandscapeComponent.h"
+#include "LandscapeHeightfieldCollisionComponent.h"
+#include "StaticMeshResources.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Static Geometry Instances"), STAT_DesignerStaticGeometryInstances, STATGROUP_Designer);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Static Geometry Triangles"), STAT_DesignerStaticGeometryTriangles, STATGROUP_Designer);
+DECLARE_CYCLE_STAT(TEXT("Static Geometry Update"), STAT_DesignerStaticGeometryUpdate, STATGROUP_Designer);
+
+namespace
+{
+	constexpr int32 MaxLeafTriangles = 4;
+
+	constexpr int32 MaxLeafInstances = 2;
+
+	constexpr int32 MaxLeafOccluders = 2;
+
+	/** The time the game thread may spend per frame gathering the triangles of components */
+	constexpr double MaxGatherSecondsPerFrame = 0.002;
+
+	/** Four rays laid out per axis, so a box is tested against all of them at once */
+	struct FRayPacket
+	{
+		VectorRegister4Float OriginX;
+		VectorRegister4Float OriginY;
+		VectorRegister4Float OriginZ;
+		VectorRegister4Float InvDirectionX;
+		VectorRegister4Float InvDirectionY;
+		VectorRegister4Float InvDirectionZ;
+		VectorRegister4Float MaxDistance;
+
+		/** The distance of the closest hit per ray, MaxDistance is loaded from it */
+		float Distances[4];
+
+		/** One bit per ray in the packet */
+		int32 ActiveMask;
+
+		void UpdateMaxDistance()
+		{
+			MaxDistance = MakeVectorRegisterFloat(Distances[0], Distances[1], Distances[2], Distances[3]);
+		}
+	};
+
+	/** Avoids infinities in the slab test, which turn into NaN when the ray starts on the plane of a box */
+	FORCEINLINE float SafeInverse(float Value)
+	{
+		return 1.F / (FMath::Abs(Value) > SMALL_NUMBER ? Value : (Value < 0.F ? -SMALL_NUMBER : SMALL_NUMBER));
+	}
+
+	FORCEINLINE bool IntersectBox(const FBox3f& Box, const FVector3f& Origin, const FVector3f& InvDirection, float MaxDistance)
+	{
+		const FVector3f T1 = (Box.Min - Origin) * InvDirection;
+		const FVector3f T2 = (Box.Max - Origin) * InvDirection;
+		const float TMin = FMath::Max3(FMath::Min(T1.X, T2.X), FMath::Min(T1.Y, T2.Y), FMath::Max(FMath::Min(T1.Z, T2.Z), 0.F));
+		const float TMax = FMath::Min3(FMath::Max(T1.X, T2.X), FMath::Max(T1.Y, T2.Y), FMath::Min(FMath::Max(T1.Z, T2.Z), MaxDistance));
+		return TMin <= TMax;
+	}
+
+	/** Returns a mask with a bit set for every active ray of the packet which intersects the box */
+	FORCEINLINE int32 IntersectBox(const FBox3f& Box, const FRayPacket& Packet)
+	{
+		const VectorRegister4Float T1X = VectorMultiply(VectorSubtract(VectorSetFloat1(Box.Min.X), Packet.OriginX), Packet.InvDirectionX);
+		const VectorRegister4Float T2X = VectorMultiply(VectorSubtract(VectorSetFloat1(Box.Max.X), Packet.OriginX), Packet.InvDirectionX);
+		const VectorRegister4Float T1Y = VectorMultiply(VectorSubtract(VectorSetFloat1(Box.Min.Y), Packet.OriginY), Packet.InvDirectionY);
+		const VectorRegister4Float T2Y = VectorMultiply(VectorSubtract(VectorSetFloat1(Box.Max.Y), Packet.OriginY), Packet.InvDirectionY);
+		const VectorRegister4Float T1Z = VectorMultiply(VectorSubtract(VectorSetFloat1(Box.Min.Z), Packet.OriginZ), Packet.InvDirectionZ);
+		const VectorRegister4Float T2Z = VectorMultiply(VectorSubtract(VectorSetFloat1(Box.Max.Z), Packet.OriginZ), Packet.InvDirectionZ);
+
+		const VectorRegister4Float TMin = VectorMax(VectorMax(VectorMin(T1X, T2X), VectorMin(T1Y, T2Y)), VectorMax(VectorMin(T1Z, T2Z), VectorSetFloat1(0.F)));
+		const VectorRegister4Float TMax = VectorMin(VectorMin(VectorMax(T1X, T2X), VectorMax(T1Y, T2Y)), VectorMin(VectorMax(T1Z, T2Z), Packet.MaxDistance));
+
+		return VectorMaskBits(VectorCompareGE(TMax, TMin)) & Packet.ActiveMask;
+	}
+
+	/** Möller-Trumbore, both sides of the triangle are hit */
+	FORCEINLINE bool IntersectTriangle(const FVector3f& Origin, const FVector3f& Direction, const FVector3f& V0, const FVector3f& V1, const FVector3f& V2, float MaxDistance, float& OutDistance)
+	{
+		const FVector3f Edge1 = V1 - V0;
+		const FVector3f Edge2 = V2 - V0;
+		const FVector3f P = FVector3f::CrossProduct(Direction, Edge2);
+		const float Determinant = FVector3f::DotProduct(Edge1, P);
+		if (FMath::Abs(Determinant) < SMALL_NUMBER)
+			return false;
+
+		const float InvDeterminant = 1.F / Determinant;
+		const FVector3f T = Origin - V0;
+		const float U = FVector3f::DotProduct(T, P) * InvDeterminant;
+		if (U < 0.F || U > 1.F)
+			return false;
+
+		const FVector3f Q = FVector3f::CrossProduct(T, Edge1);
+		const float V = FVector3f::DotProduct(Direction, Q) * InvDeterminant;
+		if (V < 0.F || U + V > 1.F)
+			return false;
+
+		const float Distance = FVector3f::DotProduct(Edge2, Q) * InvDeterminant;
+		if (Distance < 0.F || Distance >= MaxDistance)
+			return false;
+
+		OutDistance = Distance;
+		return true;
+	}
+
+	/** The normal of the triangle facing the given direction */
+	FORCEINLINE FVector3f GetFacingNormal(const FVector3f& V0, const FVector3f& V1, const FVector3f& V2, const FVector3f& FacingDirection)
+	{
+		const FVector3f Normal = FVector3f::CrossProduct(V1 - V0, V2 - V0).GetSafeNormal();
+		return FVector3f::DotProduct(Normal, FacingDirection) < 0.F ? -Normal : Normal;
+	}
+
+	/** Visit the primitives in the leaves the ray reaches, OnPrimitive may shorten MaxDistance */
+	template<typename FunctorType>
+	void TraverseRay(const FBoundingVolumeHierarchy& Hierarchy, const FVector3f& Origin, const FVector3f& InvDirection, float& MaxDistance, FunctorType&& OnPrimitive)
+	{
+		if (Hierarchy.IsEmpty())
+			return;
+
+		TArray<int32, TInlineAllocator<64>> NodeStack;
+		NodeStack.Add(0);
+
+		while (NodeStack.Num() > 0)
+		{
+			const FBoundingVolumeHierarchy::FNode& Node = Hierarchy.Nodes[NodeStack.Pop(false)];
+			if (!IntersectBox(Node.Bounds, Origin, InvDirection, MaxDistance))
+				continue;
+
+			if (Node.NumPrimitives == 0)
+			{
+				NodeStack.Add(Node.FirstIndex);
+				NodeStack.Add(Node.FirstIndex + 1);
+				continue;
+			}
+
+			for (int32 Index = Node.FirstIndex; Index < Node.FirstIndex + Node.NumPrimitives; Index++)
+			{
+				OnPrimitive(Hierarchy.PrimitiveIndices[Index]);
+			}
+		}
+	}
+
+	/** Visit the primitives in the leaves any ray of the packet reaches, together with the mask of the rays which reach it */
+	template<typename FunctorType>
+	void TraversePacket(const FBoundingVolumeHierarchy& Hierarchy, FRayPacket& Packet, FunctorType&& OnPrimitive)
+	{
+		if (Hierarchy.IsEmpty())
+			return;
+
+		TArray<int32, TInlineAllocator<64>> NodeStack;
+		NodeStack.Add(0);
+
+		while (NodeStack.Num() > 0)
+		{
+			const FBoundingVolumeHierarchy::FNode& Node = Hierarchy.Nodes[NodeStack.Pop(false)];
+			const int32 HitMask = IntersectBox(Node.Bounds, Packet);
+			if (HitMask == 0)
+				continue;
+
+			if (Node.NumPrimitives == 0)
+			{
+				NodeStack.Add(Node.FirstIndex);
+				NodeStack.Add(Node.FirstIndex + 1);
+				continue;
+			}
+
+			for (int32 Index = Node.FirstIndex; Index < Node.FirstIndex + Node.NumPrimitives; Index++)
+			{
+				OnPrimitive(Hierarchy.PrimitiveIndices[Index], HitMask);
+			}
+		}
+	}
+}
+
+void FBoundingVolumeHierarchy::Build(const TArray<FBox3f>& PrimitiveBounds, int32 MaxLeafPrimitives)
+{
+	Nodes.Reset();
+	PrimitiveIndices.Reset(PrimitiveBounds.Num());
+
+	if (PrimitiveBounds.Num() == 0)
+		return;
+
+	for (int32 Index = 0; Index < PrimitiveBounds.Num(); Index++)
+	{
+		PrimitiveIndices.Add(Index);
+	}
+
+	struct FBuildTask
+	{
+		int32 NodeIndex;
+		int32 FirstPrimitive;
+		int32 NumPrimitives;
+	};
+
+	TArray<FBuildTask, TInlineAllocator<64>> Tasks;
+	Nodes.AddDefaulted();
+	Tasks.Add({ 0, 0, PrimitiveBounds.Num() });
+
+	while (Tasks.Num() > 0)
+	{
+		const FBuildTask Task = Tasks.Pop(false);
+
+		FBox3f Bounds(ForceInit);
+		FBox3f CenterBounds(ForceInit);
+		for (int32 Index = Task.FirstPrimitive; Index < Task.FirstPrimitive + Task.NumPrimitives; Index++)
+		{
+			const FBox3f& Box = PrimitiveBounds[PrimitiveIndices[Index]];
+			Bounds += Box;
+			CenterBounds += Box.GetCenter();
+		}
+
+		Nodes[Task.NodeIndex].Bounds = Bounds;
+
+		if (Task.NumPrimitives <= MaxLeafPrimitives)
+		{
+			Nodes[Task.NodeIndex].FirstIndex = Task.FirstPrimitive;
+			Nodes[Task.NodeIndex].NumPrimitives = Task.NumPrimitives;
+			continue;
+		}
+
+		const FVector3f CenterExtent = CenterBounds.GetExtent();
+		const int32 Axis = CenterExtent.X >= CenterExtent.Y && CenterExtent.X >= CenterExtent.Z ? 0 : (CenterExtent.Y >= CenterExtent.Z ? 1 : 2);
+
+		Algo::Sort(MakeArrayView(PrimitiveIndices.GetData() + Task.FirstPrimitive, Task.NumPrimitives), [&PrimitiveBounds, Axis](int32 A, int32 B)
+		{
+			return PrimitiveBounds[A].GetCenter()[Axis] < PrimitiveBounds[B].GetCenter()[Axis];
+		});
+
+		// Both children are added together, so the second child is always directly after the first.
+		const int32 FirstChildIndex = Nodes.AddDefaulted(2);
+		Nodes[Task.NodeIndex].FirstIndex = FirstChildIndex;
+		Nodes[Task.NodeIndex].NumPrimitives = 0;
+
+		const int32 NumFirstPrimitives = Task.NumPrimitives / 2;
+		Tasks.Add({ FirstChildIndex, Task.FirstPrimitive, NumFirstPrimitives });
+		Tasks.Add({ FirstChildIndex + 1, Task.FirstPrimitive + NumFirstPrimitives, Task.NumPrimitives - NumFirstPrimitives });
+	}
+}
+
+FStaticGeometrySnapshot::FStaticGeometrySnapshot(TArray<FStaticGeometryInstanceRef>&& InInstances, TArray<FBox3f>&& InOccluderBounds)
+	: Instances(MoveTemp(InInstances))
+	, OccluderBounds(MoveTemp(InOccluderBounds))
+	, NumTriangles(0)
+{
+	TArray<FBox3f> InstanceBounds;
+	InstanceBounds.Reserve(Instances.Num());
+	for (const FStaticGeometryInstanceRef& Instance : Instances)
+	{
+		InstanceBounds.Add(Instance->Bounds);
+		NumTriangles += Instance->Vertices.Num() / 3;
+	}
+
+	Hierarchy.Build(InstanceBounds, MaxLeafInstances);
+	OccluderHierarchy.Build(OccluderBounds, MaxLeafOccluders);
+}
+
+bool FStaticGeometrySnapshot::Raycast(const FStaticGeometryRay& Ray, FStaticGeometryHit& OutHit) const
+{
+	const FVector3f InvDirection(SafeInverse(Ray.Direction.X), SafeInverse(Ray.Direction.Y), SafeInverse(Ray.Direction.Z));
+	float MaxDistance = Ray.MaxDistance;
+
+	const FStaticGeometryInstance* HitInstance = nullptr;
+	int32 HitTriangle = INDEX_NONE;
+
+	TraverseRay(Hierarchy, Ray.Origin, InvDirection, MaxDistance, [&](int32 InstanceIndex)
+	{
+		const FStaticGeometryInstance& Instance = *Instances[InstanceIndex];
+		TraverseRay(Instance.Hierarchy, Ray.Origin, InvDirection, MaxDistance, [&](int32 TriangleIndex)
+		{
+			const FVector3f* Triangle = &Instance.Vertices[TriangleIndex * 3];
+			float Distance;
+			if (IntersectTriangle(Ray.Origin, Ray.Direction, Triangle[0], Triangle[1], Triangle[2], MaxDistance, Distance))
+			{
+				MaxDistance = Distance;
+				HitInstance = &Instance;
+				HitTriangle = TriangleIndex;
+			}
+		});
+	});
+
+	if (HitInstance == nullptr)
+		return false;
+
+	const FVector3f* Triangle = &HitInstance->Vertices[HitTriangle * 3];
+	OutHit.Distance = MaxDistance;
+	OutHit.Location = Ray.Origin + Ray.Direction * MaxDistance;
+	OutHit.Normal = GetFacingNormal(Triangle[0], Triangle[1], Triangle[2], -Ray.Direction);
+	OutHit.Component = HitInstance->Component;
+	return true;
+}
+
+bool FStaticGeometrySnapshot::IsOccluded(const FStaticGeometryRay& Ray) const
+{
+	const FVector3f InvDirection(SafeInverse(Ray.Direction.X), SafeInverse(Ray.Direction.Y), SafeInverse(Ray.Direction.Z));
+	float MaxDistance = Ray.MaxDistance;
+	bool bIsOccluded = false;
+
+	// Any hit will do, a negative max distance rejects every remaining box.
+	TraverseRay(OccluderHierarchy, Ray.Origin, InvDirection, MaxDistance, [&](int32 OccluderIndex)
+	{
+		if (IntersectBox(OccluderBounds[OccluderIndex], Ray.Origin, InvDirection, MaxDistance))
+		{
+			bIsOccluded = true;
+			MaxDistance = -1.F;
+		}
+	});
+
+	TraverseRay(Hierarchy, Ray.Origin, InvDirection, MaxDistance, [&](int32 InstanceIndex)
+	{
+		const FStaticGeometryInstance& Instance = *Instances[InstanceIndex];
+		TraverseRay(Instance.Hierarchy, Ray.Origin, InvDirection, MaxDistance, [&](int32 TriangleIndex)
+		{
+			const FVector3f* Triangle = &Instance.Vertices[TriangleIndex * 3];
+			float Distance;
+			if (IntersectTriangle(Ray.Origin, Ray.Direction, Triangle[0], Triangle[1], Triangle[2], MaxDistance, Distance))
+			{
+				bIsOccluded = true;
+				MaxDistance = -1.F;
+			}
+		});
+	});
+
+	return bIsOccluded;
+}
+
+void FStaticGeometrySnapshot::RaycastPacket(TArrayView<const FStaticGeometryRay> Rays, TArrayView<FStaticGeometryHit> OutHits) const
+{
+	check(Rays.Num() <= 4 && OutHits.Num() >= Rays.Num());
+
+	FRayPacket Packet;
+	float Values[6][4];
+	Packet.ActiveMask = 0;
+	for (int32 Lane = 0; Lane < 4; Lane++)
+	{
+		// Unused lanes repeat the first ray, they are masked out.
+		const FStaticGeometryRay& Ray = Rays[Lane < Rays.Num() ? Lane : 0];
+		Values[0][Lane] = Ray.Origin.X;
+		Values[1][Lane] = Ray.Origin.Y;
+		Values[2][Lane] = Ray.Origin.Z;
+		Values[3][Lane] = SafeInverse(Ray.Direction.X);
+		Values[4][Lane] = SafeInverse(Ray.Direction.Y);
+		Values[5][Lane] = SafeInverse(Ray.Direction.Z);
+		Packet.Distances[Lane] = Ray.MaxDistance;
+		Packet.ActiveMask |= Lane < Rays.Num() ? 1 << Lane : 0;
+	}
+
+	Packet.OriginX = VectorLoad(Values[0]);
+	Packet.OriginY = VectorLoad(Values[1]);
+	Packet.OriginZ = VectorLoad(Values[2]);
+	Packet.InvDirectionX = VectorLoad(Values[3]);
+	Packet.InvDirectionY = VectorLoad(Values[4]);
+	Packet.InvDirectionZ = VectorLoad(Values[5]);
+	Packet.UpdateMaxDistance();
+
+	const FStaticGeometryInstance* HitInstances[4] = { nullptr, nullptr, nullptr, nullptr };
+	int32 HitTriangles[4] = { INDEX_NONE, INDEX_NONE, INDEX_NONE, INDEX_NONE };
+
+	TraversePacket(Hierarchy, Packet, [&](int32 InstanceIndex, int32 InstanceMask)
+	{
+		const FStaticGeometryInstance& Instance = *Instances[InstanceIndex];
+		TraversePacket(Instance.Hierarchy, Packet, [&](int32 TriangleIndex, int32 TriangleMask)
+		{
+			const FVector3f* Triangle = &Instance.Vertices[TriangleIndex * 3];
+			bool bHasHit = false;
+			for (int32 Lane = 0; Lane < Rays.Num(); Lane++)
+			{
+				float Distance;
+				if ((TriangleMask & (1 << Lane)) != 0 && IntersectTriangle(Rays[Lane].Origin, Rays[Lane].Direction, Triangle[0], Triangle[1], Triangle[2], Packet.Distances[Lane], Distance))
+				{
+					Packet.Distances[Lane] = Distance;
+					HitInstances[Lane] = &Instance;
+					HitTriangles[Lane] = TriangleIndex;
+					bHasHit = true;
+				}
+			}
+
+			if (bHasHit)
+			{
+				Packet.UpdateMaxDistance();
+			}
+		});
+	});
+
+	for (int32 Lane = 0; Lane < Rays.Num(); Lane++)
+	{
+		FStaticGeometryHit& Hit = OutHits[Lane];
+		Hit = FStaticGeometryHit();
+
+		if (HitInstances[Lane] != nullptr)
+		{
+			const FVector3f* Triangle = &HitInstances[Lane]->Vertices[HitTriangles[Lane] * 3];
+			Hit.Distance = Packet.Distances[Lane];
+			Hit.Location = Rays[Lane].Origin + Rays[Lane].Direction * Hit.Distance;
+			Hit.Normal = GetFacingNormal(Triangle[0], Triangle[1], Triangle[2], -Rays[Lane].Direction);
+			Hit.Component = HitInstances[Lane]->Component;
+		}
+	}
+}
+
+void FStaticGeometrySnapshot::RaycastBatch(TArrayView<const FStaticGeometryRay> Rays, TArrayView<FStaticGeometryHit> OutHits) const
+{
+	check(OutHits.Num() >= Rays.Num());
+
+	const int32 NumPackets = FMath::DivideAndRoundUp(Rays.Num(), 4);
+	ParallelFor(NumPackets, [this, Rays, OutHits](int32 PacketIndex)
+	{
+		const int32 FirstRay = PacketIndex * 4;
+		const int32 NumRays = FMath::Min(4, Rays.Num() - FirstRay);
+		RaycastPacket(Rays.Slice(FirstRay, NumRays), OutHits.Slice(FirstRay, NumRays));
+	}, NumPackets < 4);
+}
+
+bool FStaticGeometrySnapshot::FindClosestPoint(const FVector3f& Point, float MaxDistance, FStaticGeometryHit& OutHit) const
+{
+	if (Hierarchy.IsEmpty())
+		return false;
+
+	float ClosestDistanceSquared = FMath::Square(MaxDistance);
+	bool bHasHit = false;
+
+	TArray<TPair<const FStaticGeometryInstance*, int32>, TInlineAllocator<64>> NodeStack;
+	NodeStack.Emplace(nullptr, 0);
+
+	while (NodeStack.Num() > 0)
+	{
+		const TPair<const FStaticGeometryInstance*, int32> Entry = NodeStack.Pop(false);
+		const FBoundingVolumeHierarchy& NodeHierarchy = Entry.Key != nullptr ? Entry.Key->Hierarchy : Hierarchy;
+		const FBoundingVolumeHierarchy::FNode& Node = NodeHierarchy.Nodes[Entry.Value];
+
+		if (Node.Bounds.ComputeSquaredDistanceToPoint(Point) > ClosestDistanceSquared)
+			continue;
+
+		if (Node.NumPrimitives == 0)
+		{
+			NodeStack.Emplace(Entry.Key, Node.FirstIndex);
+			NodeStack.Emplace(Entry.Key, Node.FirstIndex + 1);
+			continue;
+		}
+
+		for (int32 Index = Node.FirstIndex; Index < Node.FirstIndex + Node.NumPrimitives; Index++)
+		{
+			const int32 PrimitiveIndex = NodeHierarchy.PrimitiveIndices[Index];
+
+			// Leaves of the instance hierarchy continue into the hierarchy of the instance.
+			if (Entry.Key == nullptr)
+			{
+				if (!Instances[PrimitiveIndex]->Hierarchy.IsEmpty())
+				{
+					NodeStack.Emplace(&Instances[PrimitiveIndex].Get(), 0);
+				}
+				continue;
+			}
+
+			const FVector3f* Triangle = &Entry.Key->Vertices[PrimitiveIndex * 3];
+			const FVector3f ClosestPoint = (FVector3f)FMath::ClosestPointOnTriangleToPoint((FVector)Point, (FVector)Triangle[0], (FVector)Triangle[1], (FVector)Triangle[2]);
+			const float DistanceSquared = FVector3f::DistSquared(ClosestPoint, Point);
+			if (DistanceSquared <= ClosestDistanceSquared)
+			{
+				ClosestDistanceSquared = DistanceSquared;
+				bHasHit = true;
+
+				OutHit.Distance = FMath::Sqrt(DistanceSquared);
+				OutHit.Location = ClosestPoint;
+				OutHit.Normal = GetFacingNormal(Triangle[0], Triangle[1], Triangle[2], Point - ClosestPoint);
+				OutHit.Component = Entry.Key->Component;
+			}
+		}
+	}
+
+	return bHasHit;
+}
+
+FStaticGeometryBVH::FStaticGeometryBVH()
+	: Region(ForceInit)
+	, bNeedsValidation(false)
+	, LastUpdateFrameCounter(0)
+	, BuildStartTime(0.0)
+{
+
+}
+
+void FStaticGeometryBVH::Build(UWorld* InWorld, ULevel* InLevel, const FBox& InRegion)
+{
+	Empty();
+
+	if (InWorld == nullptr)
+		return;
+
+	World = InWorld;
+	Level = InLevel;
+	Region = InRegion;
+	BuildStartTime = FPlatformTime::Seconds();
+
+	// Only the components are queued here, their triangles are gathered over the next frames so activating the tool doesn't hitch.
+	QueueComponents();
+
+	UE_LOG(LogDesigner, Log, TEXT("StaticGeometryBVH: Queued %d components."), DirtyComponents.Num());
+}
+
+bool FStaticGeometryBVH::IsBuiltFrom(const UWorld* InWorld, const ULevel* InLevel, const FBox& InRegion) const
+{
+	if (InWorld == nullptr || World.Get() != InWorld || Region != InRegion)
+		return false;
+
+	// The level doesn't matter when the region is gathered.
+	return Region.IsValid || Level.Get() == InLevel;
+}
+
+void FStaticGeometryBVH::NotifyActorChanged(const AActor* Actor)
+{
+	if (!World.IsValid() || Actor == nullptr || Actor->GetWorld() != World.Get())
+		return;
+
+	Actor->ForEachComponent<UPrimitiveComponent>(false, [this](UPrimitiveComponent* Component)
+	{
+		DirtyComponents.Add(TObjectKey<UPrimitiveComponent>(Component), Component);
+	});
+}
+
+void FStaticGeometryBVH::Validate()
+{
+	bNeedsValidation = World.IsValid();
+}
+
+bool FStaticGeometryBVH::CanTestOcclusion(const FVector& Start, const FVector& End) const
+{
+	if (!Snapshot.IsValid() || DirtyComponents.Num() > 0 || bNeedsValidation)
+		return false;
+
+	// Primitives outside the region aren't gathered, the box is convex so the segment is inside when both ends are.
+	if (Region.IsValid)
+		return Region.IsInsideOrOn(Start) && Region.IsInsideOrOn(End);
+
+	// Only the current level is gathered, other levels may have anything in them.
+	const UWorld* GatheredWorld = World.Get();
+	return GatheredWorld != nullptr && GatheredWorld->GetNumLevels() == 1;
+}
+
+bool FStaticGeometryBVH::Update()
+{
+	if (!World.IsValid() || LastUpdateFrameCounter == GFrameCounter)
+		return false;
+
+	LastUpdateFrameCounter = GFrameCounter;
+
+	SCOPE_CYCLE_COUNTER(STAT_DesignerStaticGeometryUpdate);
+
+	bool bSnapshotChanged = false;
+	if (bNeedsValidation)
+	{
+		bNeedsValidation = false;
+		bSnapshotChanged = ValidateInstances();
+	}
+
+	if (DirtyComponents.Num() > 0)
+	{
+		const double EndTime = FPlatformTime::Seconds() + MaxGatherSecondsPerFrame;
+
+		// Reading the mesh data has to happen on the game thread, the hierarchies are built in parallel.
+		TArray<TPair<TObjectKey<UPrimitiveComponent>, TSharedPtr<FStaticGeometryInstance, ESPMode::ThreadSafe>>> NewInstances;
+		for (auto It = DirtyComponents.CreateIterator(); It; ++It)
+		{
+			// Deleted components are removed, components which are no longer static only keep their bounds.
+			const UPrimitiveComponent* Component = It.Value().Get();
+			if (IsStaticGeometry(Component))
+			{
+				NewInstances.Emplace(It.Key(), GatherInstance(CastChecked<UStaticMeshComponent>(Component)));
+				bSnapshotChanged |= OccluderBounds.Remove(It.Key()) > 0;
+			}
+			else
+			{
+				bSnapshotChanged |= Instances.Remove(It.Key()) > 0;
+
+				if (IsOccluder(Component))
+				{
+					OccluderBounds.Add(It.Key(), (FBox3f)Component->Bounds.GetBox());
+					bSnapshotChanged = true;
+				}
+				else
+				{
+					bSnapshotChanged |= OccluderBounds.Remove(It.Key()) > 0;
+				}
+			}
+
+			It.RemoveCurrent();
+
+			if (FPlatformTime::Seconds() > EndTime)
+				break;
+		}
+
+		ParallelFor(NewInstances.Num(), [&NewInstances](int32 Index)
+		{
+			BuildInstanceHierarchy(*NewInstances[Index].Value);
+		});
+
+		for (const TPair<TObjectKey<UPrimitiveComponent>, TSharedPtr<FStaticGeometryInstance, ESPMode::ThreadSafe>>& NewInstance : NewInstances)
+		{
+			Instances.Add(NewInstance.Key, NewInstance.Value.ToSharedRef());
+		}
+
+		// Queries keep using the previous snapshot until every queued component is gathered.
+		if (DirtyComponents.Num() > 0)
+			return false;
+	}
+	else if (!bSnapshotChanged)
+	{
+		return false;
+	}
+
+	const bool bIsFirstSnapshot = !Snapshot.IsValid();
+	UpdateSnapshot();
+
+	if (bIsFirstSnapshot)
+	{
+		UE_LOG(LogDesigner, Log, TEXT("StaticGeometryBVH: Gathered %d components with %d triangles in %.2f ms."), Snapshot->NumInstances(), Snapshot->GetNumTriangles(), (FPlatformTime::Seconds() - BuildStartTime) * 1000.0);
+	}
+
+	return true;
+}
+
+void FStaticGeometryBVH::Empty()
+{
+	World.Reset();
+	Level.Reset();
+	Region = FBox(ForceInit);
+	Instances.Empty();
+	OccluderBounds.Empty();
+	DirtyComponents.Empty();
+	bNeedsValidation = false;
+	Snapshot.Reset();
+
+	SET_DWORD_STAT(STAT_DesignerStaticGeometryInstances, 0);
+	SET_DWORD_STAT(STAT_DesignerStaticGeometryTriangles, 0);
+}
+
+void FStaticGeometryBVH::QueueComponents()
+{
+	auto QueueActor = [this](const AActor* Actor)
+	{
+		if (Actor == nullptr)
+			return;
+
+		Actor->ForEachComponent<UPrimitiveComponent>(false, [this](UPrimitiveComponent* Component)
+		{
+			const TObjectKey<UPrimitiveComponent> Key(Component);
+			if (!Instances.Contains(Key) && !OccluderBounds.Contains(Key) && (IsStaticGeometry(Component) || IsOccluder(Component)))
+			{
+				DirtyComponents.Add(Key, Component);
+			}
+		});
+	};
+
+	if (Region.IsValid)
+	{
+		for (TActorIterator<AActor> ActorIterator(World.Get()); ActorIterator; ++ActorIterator)
+		{
+			QueueActor(*ActorIterator);
+		}
+	}
+	else if (const ULevel* GatheredLevel = Level.Get())
+	{
+		for (const AActor* Actor : GatheredLevel->Actors)
+		{
+			QueueActor(Actor);
+		}
+	}
+}
+
+bool FStaticGeometryBVH::ValidateInstances()
+{
+	bool bRemovedInstances = false;
+
+	for (auto It = Instances.CreateIterator(); It; ++It)
+	{
+		const UStaticMeshComponent* Component = It.Value()->Component.Get();
+		if (Component == nullptr)
+		{
+			It.RemoveCurrent();
+			bRemovedInstances = true;
+		}
+		else if (!IsStaticGeometry(Component) || !IsInstanceUpToDate(*It.Value(), Component))
+		{
+			DirtyComponents.Add(It.Key(), const_cast<UStaticMeshComponent*>(Component));
+		}
+	}
+
+	for (auto It = OccluderBounds.CreateIterator(); It; ++It)
+	{
+		const UPrimitiveComponent* Component = It.Key().ResolveObjectPtr();
+		if (Component == nullptr)
+		{
+			It.RemoveCurrent();
+			bRemovedInstances = true;
+		}
+		else if (!IsOccluder(Component) || It.Value() != (FBox3f)Component->Bounds.GetBox())
+		{
+			DirtyComponents.Add(It.Key(), const_cast<UPrimitiveComponent*>(Component));
+		}
+	}
+
+	// Undo and redo can bring back actors without notifying they were added.
+	QueueComponents();
+
+	return bRemovedInstances;
+}
+
+bool FStaticGeometryBVH::IsInstanceUpToDate(const FStaticGeometryInstance& Instance, const UStaticMeshComponent* Component)
+{
+	const UInstancedStaticMeshComponent* InstancedComponent = Cast<UInstancedStaticMeshComponent>(Component);
+	return Instance.StaticMesh == Component->GetStaticMesh()
+		&& Instance.NumMeshInstances == (InstancedComponent != nullptr ? InstancedComponent->GetInstanceCount() : 1)
+		&& Instance.ComponentTransform.Equals(Component->GetComponentTransform());
+}
+
+bool FStaticGeometryBVH::IsGathered(const UPrimitiveComponent* Component) const
+{
+	if (!IsValid(Component) || !Component->IsRegistered() || Component->GetWorld() != World.Get())
+		return false;
+
+	if (!Component->IsVisibleInEditor() || !Component->IsCollisionEnabled())
+		return false;
+
+	// The previews of the tool follow the cursor, they are never placed on.
+	const AActor* Owner = Component->GetOwner();
+	if (Owner == nullptr || Owner->IsHiddenEd() || Owner->bIsEditorPreviewActor)
+		return false;
+
+	if (!Region.IsValid && Component->GetComponentLevel() != Level.Get())
+		return false;
+
+	return !Region.IsValid || Region.Intersect(Component->Bounds.GetBox());
+}
+
+bool FStaticGeometryBVH::IsStaticGeometry(const UPrimitiveComponent* Component) const
+{
+	const UStaticMeshComponent* StaticMeshComponent = Cast<UStaticMeshComponent>(Component);
+	if (StaticMeshComponent == nullptr || StaticMeshComponent->Mobility != EComponentMobility::Static)
+		return false;
+
+	const UStaticMesh* StaticMesh = StaticMeshComponent->GetStaticMesh();
+	if (StaticMesh == nullptr || StaticMesh->GetRenderData() == nullptr || StaticMesh->GetRenderData()->LODResources.Num() == 0)
+		return false;
+
+	return IsGathered(Component);
+}
+
+bool FStaticGeometryBVH::IsOccluder(const UPrimitiveComponent* Component) const
+{
+	if (Component == nullptr || Component->IsA<ULandscapeHeightfieldCollisionComponent>() || Component->IsA<ULandscapeComponent>())
+		return false;
+
+	return !IsStaticGeometry(Component) && IsGathered(Component);
+}
+
+TSharedPtr<FStaticGeometryInstance, ESPMode::ThreadSafe> FStaticGeometryBVH::GatherInstance(const UStaticMeshComponent* Component)
+{
+	TSharedPtr<FStaticGeometryInstance, ESPMode::ThreadSafe> Instance = MakeShared<FStaticGeometryInstance, ESPMode::ThreadSafe>();
+	Instance->Component = Component;
+	Instance->StaticMesh = Component->GetStaticMesh();
+	Instance->ComponentTransform = Component->GetComponentTransform();
+
+	const FStaticMeshLODResources& LODResources = Component->GetStaticMesh()->GetRenderData()->LODResources[0];
+	const FPositionVertexBuffer& PositionVertexBuffer = LODResources.VertexBuffers.PositionVertexBuffer;
+	const FIndexArrayView Indices = LODResources.IndexBuffer.GetArrayView();
+
+	// Instanced components have a copy of the triangles per instance.
+	TArray<FTransform, TInlineAllocator<1>> Transforms;
+	if (const UInstancedStaticMeshComponent* InstancedComponent = Cast<UInstancedStaticMeshComponent>(Component))
+	{
+		for (int32 InstanceIndex = 0; InstanceIndex < InstancedComponent->GetInstanceCount(); InstanceIndex++)
+		{
+			InstancedComponent->GetInstanceTransform(InstanceIndex, Transforms.AddDefaulted_GetRef(), true);
+		}
+	}
+	else
+	{
+		Transforms.Add(Component->GetComponentTransform());
+	}
+
+	Instance->NumMeshInstances = Transforms.Num();
+	Instance->Vertices.Reserve(Transforms.Num() * Indices.Num());
+	for (const FTransform& Transform : Transforms)
+	{
+		for (int32 Index = 0; Index < Indices.Num(); Index++)
+		{
+			Instance->Vertices.Add((FVector3f)Transform.TransformPosition((FVector)PositionVertexBuffer.VertexPosition(Indices[Index])));
+		}
+	}
+
+	return Instance;
+}
+
+void FStaticGeometryBVH::BuildInstanceHierarchy(FStaticGeometryInstance& Instance)
+{
+	const int32 NumTriangles = Instance.Vertices.Num() / 3;
+
+	TArray<FBox3f> TriangleBounds;
+	TriangleBounds.Reserve(NumTriangles);
+
+	Instance.Bounds = FBox3f(ForceInit);
+	for (int32 TriangleIndex = 0; TriangleIndex < NumTriangles; TriangleIndex++)
+	{
+		const FVector3f* Triangle = &Instance.Vertices[TriangleIndex * 3];
+		FBox3f& Bounds = TriangleBounds.Emplace_GetRef(ForceInit);
+		Bounds += Triangle[0];
+		Bounds += Triangle[1];
+		Bounds += Triangle[2];
+		Instance.Bounds += Bounds;
+	}
+
+	Instance.Hierarchy.Build(TriangleBounds, MaxLeafTriangles);
+}
+
+void FStaticGeometryBVH::UpdateSnapshot()
+{
+	TArray<FStaticGeometryInstanceRef> SnapshotInstances;
+	Instances.GenerateValueArray(SnapshotInstances);
+
+	TArray<FBox3f> SnapshotOccluderBounds;
+	OccluderBounds.GenerateValueArray(SnapshotOccluderBounds);
+
+	// Queries still running on other threads keep the previous snapshot alive.
+	Snapshot = MakeShared<FStaticGeometrySnapshot, ESPMode::ThreadSafe>(MoveTemp(SnapshotInstances), MoveTemp(SnapshotOccluderBounds));
+
+	SET_DWORD_STAT(STAT_DesignerStaticGeometryInstances, Snapshot->NumInstances());
+	SET_DWORD_STAT(STAT_DesignerStaticGeometryTriangles, Snapshot->GetNumTriangles());
+}
@@ -0,0 +1,243 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class AActor;
+class ULevel;
+class UPrimitiveComponent;
+class UStaticMesh;
+class UStaticMeshComponent;
+class UWorld;
+
+/** A ray for the static geometry queries */
+struct FStaticGeometryRay
+{
+	FVector3f Origin = FVector3f::ZeroVector;
+
+	/** Normalized direction */
+	FVector3f Direction = FVector3f::ForwardVector;
+
+	float MaxDistance = WORLD_MAX;
+};
+
+/** The result of a static geometry query */
+struct FStaticGeometryHit
+{
+	float Distance = MAX_flt;
+
+	FVector3f Location = FVector3f::ZeroVector;
+
+	/** The triangle normal, facing the ray origin or the query point */
+	FVector3f Normal = FVector3f::UpVector;
+
+	/** The component which was hit, only resolve it on the game thread */
+	TWeakObjectPtr<const UStaticMeshComponent> Component;
+
+	FORCEINLINE bool IsHit() const { return Distance < MAX_flt; }
+};
+
+/** Bounding volume hierarchy over primitives given by their bounds */
+struct FBoundingVolumeHierarchy
+{
+	struct FNode
+	{
+		FBox3f Bounds;
+
+		/** The first child for inner nodes, the second child directly follows it. The first entry in PrimitiveIndices for leaves. */
+		int32 FirstIndex = 0;
+
+		/** Zero for inner nodes */
+		int32 NumPrimitives = 0;
+	};
+
+	TArray<FNode> Nodes;
+
+	TArray<int32> PrimitiveIndices;
+
+	/** Split the primitives at the median of their centers on the longest axis until a node has no more than MaxLeafPrimitives */
+	void Build(const TArray<FBox3f>& PrimitiveBounds, int32 MaxLeafPrimitives);
+
+	FORCEINLINE bool IsEmpty() const { return Nodes.Num() == 0; }
+};
+
+/** The triangles of a single static mesh component in world space */
+struct FStaticGeometryInstance
+{
+	TWeakObjectPtr<const UStaticMeshComponent> Component;
+
+	/** Three vertices per triangle */
+	TArray<FVector3f> Vertices;
+
+	FBoundingVolumeHierarchy Hierarchy;
+
+	FBox3f Bounds;
+
+	/** The state of the component when it was gathered, to find changes which were not notified. The mesh is only compared, never dereferenced. */
+	const UStaticMesh* StaticMesh = nullptr;
+
+	FTransform ComponentTransform;
+
+	int32 NumMeshInstances = 1;
+};
+
+typedef TSharedRef<const FStaticGeometryInstance, ESPMode::ThreadSafe> FStaticGeometryInstanceRef;
+
+/**
+ * An immutable snapshot of the static geometry, which can be queried from any thread while the game thread builds the next snapshot.
+ */
+class FStaticGeometrySnapshot
+{
+private:
+	TArray<FStaticGeometryInstanceRef> Instances;
+
+	/** The hierarchy over the bounds of the instances */
+	FBoundingVolumeHierarchy Hierarchy;
+
+	/** The bounds of the colliding primitives whose triangles aren't gathered, like movable meshes and BSP */
+	TArray<FBox3f> OccluderBounds;
+
+	FBoundingVolumeHierarchy OccluderHierarchy;
+
+	int32 NumTriangles;
+
+public:
+	FStaticGeometrySnapshot(TArray<FStaticGeometryInstanceRef>&& InInstances, TArray<FBox3f>&& InOccluderBounds);
+
+	/** Returns true if the ray hit a triangle, OutHit is the closest hit */
+	bool Raycast(const FStaticGeometryRay& Ray, FStaticGeometryHit& OutHit) const;
+
+	/** Returns true if a triangle or the bounds of an occluder is within the max distance of the ray, so anything behind it may be hidden */
+	bool IsOccluded(const FStaticGeometryRay& Ray) const;
+
+	/** Trace up to four rays together, the bounds of the hierarchy are tested against all rays at once */
+	void RaycastPacket(TArrayView<const FStaticGeometryRay> Rays, TArrayView<FStaticGeometryHit> OutHits) const;
+
+	/** Trace the rays in packets of four, spread over the worker threads */
+	void RaycastBatch(TArrayView<const FStaticGeometryRay> Rays, TArrayView<FStaticGeometryHit> OutHits) const;
+
+	/** Returns true if a triangle is within MaxDistance of the point, OutHit is the closest point on it */
+	bool FindClosestPoint(const FVector3f& Point, float MaxDistance, FStaticGeometryHit& OutHit) const;
+
+	FORCEINLINE int32 NumInstances() const { return Instances.Num(); }
+
+	FORCEINLINE int32 GetNumTriangles() const { return NumTriangles; }
+};
+
+typedef TSharedPtr<const FStaticGeometrySnapshot, ESPMode::ThreadSafe> FStaticGeometrySnapshotPtr;
+
+/**
+ * Keeps a snapshot of the triangles of the static meshes in a level, or in a region of the world, together with the bounds of the other colliding primitives.
+ * Components are gathered on the game thread within a time budget per frame, and only changed components are gathered again for the next snapshot.
+ */
+class FStaticGeometryBVH
+{
+private:
+	TWeakObjectPtr<UWorld> World;
+
+	/** The level which is gathered when the region isn't valid */
+	TWeakObjectPtr<ULevel> Level;
+
+	/** When valid the components of every level overlapping it are gathered instead of the level */
+	FBox Region;
+
+	TMap<TObjectKey<UPrimitiveComponent>, FStaticGeometryInstanceRef> Instances;
+
+	/** The bounds of the other colliding primitives, only used to tell whether something may block a ray */
+	TMap<TObjectKey<UPrimitiveComponent>, FBox3f> OccluderBounds;
+
+	/** Components which changed since the last snapshot, or which still have to be gathered after a build */
+	TMap<TObjectKey<UPrimitiveComponent>, TWeakObjectPtr<UPrimitiveComponent>> DirtyComponents;
+
+	/** True if the instances have to be checked against their components, after undo, redo or reinstancing changed components without notifying */
+	bool bNeedsValidation;
+
+	/** The frame of the last update, the update is called for every viewport but only runs once per frame */
+	uint64 LastUpdateFrameCounter;
+
+	/** The time the build was started, for the log when the first snapshot is made */
+	double BuildStartTime;
+
+	FStaticGeometrySnapshotPtr Snapshot;
+
+public:
+	FStaticGeometryBVH();
+
+	/**
+	 * Queue the static geometry of the level, or of every level within the region when the region is valid.
+	 * The components are gathered by the following updates, there is no snapshot until all of them are gathered.
+	 */
+	void Build(UWorld* InWorld, ULevel* InLevel, const FBox& InRegion);
+
+	/** Returns true if the static geometry is built, or being built, from the world, level and region */
+	bool IsBuiltFrom(const UWorld* InWorld, const ULevel* InLevel, const FBox& InRegion) const;
+
+	/** Remember the primitive components of the actor, so they are gathered again by the next update */
+	void NotifyActorChanged(const AActor* Actor);
+
+	/** Check every instance against its component and look for new components in the next update, for changes which were not notified */
+	void Validate();
+
+	/** Gather queued components within the time budget of a frame and make a new snapshot once all are gathered. Returns true if the snapshot changed. */
+	bool Update();
+
+	void Empty();
+
+	FORCEINLINE bool IsBuilt() const { return Snapshot.IsValid(); }
+
+	/** Returns true if the snapshot is up to date and holds every primitive which can block the segment, so IsOccluded can replace a physics trace */
+	bool CanTestOcclusion(const FVector& Start, const FVector& End) const;
+
+	/** The latest snapshot, it is never changed so it can be passed to other threads */
+	FORCEINLINE FStaticGeometrySnapshotPtr GetSnapshot() const { return Snapshot; }
+
+private:
+	/** Returns true if the component is a visible, colliding primitive of the gathered level or region */
+	bool IsGathered(const UPrimitiveComponent* Component) const;
+
+	/** Returns true if the triangles of the component belong in the snapshot */
+	bool IsStaticGeometry(const UPrimitiveComponent* Component) const;
+
+	/** Returns true if only the bounds of the component belong in the snapshot, landscapes are left to their heightfields */
+	bool IsOccluder(const UPrimitiveComponent* Component) const;
+
+	/** Queue the static geometry components of the level or region which are not gathered yet */
+	void QueueComponents();
+
+	/** Remove the instances and occluders of deleted components and queue the components which changed. Returns true if any were removed. */
+	bool ValidateInstances();
+
+	/** Returns true if the component still has the mesh, transform and mesh instances it had when the instance was gathered */
+	static bool IsInstanceUpToDate(const FStaticGeometryInstance& Instance, const UStaticMeshComponent* Component);
+
+	/** Copy the triangles of the component in world space and gather them in a new instance */
+	static TSharedPtr<FStaticGeometryInstance, ESPMode::ThreadSafe> GatherInstance(const UStaticMeshComponent* Component);
+
+	static void BuildInstanceHierarchy(FStaticGeometryInstance& Instance);
+
+	void UpdateSnapshot();
+};
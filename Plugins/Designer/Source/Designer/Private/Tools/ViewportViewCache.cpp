@@ -0,0 +1,127 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "ViewportViewCache.h"
+#include "DesignerModule.h"
+
+#include "Editor.h"
+#include "EditorViewportClient.h"
+#include "SceneView.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("View Cache Hits"), STAT_DesignerViewCacheHits, STATGROUP_Designer);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("View Cache Misses"), STAT_DesignerViewCacheMisses, STATGROUP_Designer);
+
+FViewportViewCache::FViewportViewCache()
+	: HitCount(0)
+	, MissCount(0)
+{
+
+}
+
+const FSceneView* FViewportViewCache::GetView(FEditorViewportClient* ViewportClient)
+{
+	if (ViewportClient == nullptr || ViewportClient->Viewport == nullptr)
+		return nullptr;
+
+	FViewport* Viewport = ViewportClient->Viewport;
+
+	FCachedView* FoundView = Views.Find(ViewportClient);
+	const bool bIsUpToDate = FoundView != nullptr
+		&& FoundView->View != nullptr
+		&& FoundView->ViewLocation == ViewportClient->GetViewLocation()
+		&& FoundView->ViewRotation == ViewportClient->GetViewRotation()
+		&& FoundView->ViewFOV == ViewportClient->ViewFOV
+		&& FoundView->OrthoZoom == ViewportClient->GetOrthoZoom()
+		&& FoundView->ViewportSize == Viewport->GetSizeXY()
+		&& FoundView->Viewport == Viewport
+		&& FoundView->ViewportType == (int32)ViewportClient->GetViewportType()
+		&& FoundView->Scene == ViewportClient->GetScene()
+		// The placement traces filter hits by the show flags of the view family, like BSP, volumes and landscape.
+		&& AreShowFlagsEqual(FoundView->ViewFamily->EngineShowFlags, ViewportClient->EngineShowFlags);
+
+	if (bIsUpToDate)
+	{
+		HitCount++;
+		SET_DWORD_STAT(STAT_DesignerViewCacheHits, HitCount);
+		return FoundView->View;
+	}
+
+	MissCount++;
+	SET_DWORD_STAT(STAT_DesignerViewCacheMisses, MissCount);
+
+	// Views are only calculated again on a miss, so this is also the moment to release the views of closed viewports.
+	RemoveClosedViewports();
+
+	FCachedView& CachedView = Views.FindOrAdd(ViewportClient);
+
+	CachedView.ViewLocation = ViewportClient->GetViewLocation();
+	CachedView.ViewRotation = ViewportClient->GetViewRotation();
+	CachedView.ViewFOV = ViewportClient->ViewFOV;
+	CachedView.OrthoZoom = ViewportClient->GetOrthoZoom();
+	CachedView.ViewportSize = Viewport->GetSizeXY();
+	CachedView.Viewport = Viewport;
+	CachedView.ViewportType = (int32)ViewportClient->GetViewportType();
+	CachedView.Scene = ViewportClient->GetScene();
+
+	// The old view is deleted with its view family.
+	CachedView.ViewFamily = MakeShared<FSceneViewFamilyContext>(FSceneViewFamily::ConstructionValues(
+		Viewport,
+		ViewportClient->GetScene(),
+		ViewportClient->EngineShowFlags)
+		.SetRealtimeUpdate(ViewportClient->IsRealtime()));
+	CachedView.View = ViewportClient->CalcSceneView(CachedView.ViewFamily.Get());
+
+	return CachedView.View;
+}
+
+void FViewportViewCache::Empty()
+{
+	Views.Empty();
+}
+
+void FViewportViewCache::RemoveClosedViewports()
+{
+	if (GEditor == nullptr)
+		return;
+
+	const TArray<FEditorViewportClient*>& ViewportClients = GEditor->GetAllViewportClients();
+	for (auto It = Views.CreateIterator(); It; ++It)
+	{
+		if (!ViewportClients.Contains(It.Key()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+bool FViewportViewCache::AreShowFlagsEqual(const FEngineShowFlags& A, const FEngineShowFlags& B)
+{
+	for (uint32 Index = 0; Index < FEngineShowFlags::SF_FirstCustom; Index++)
+	{
+		if (A.GetSingleFlag(Index) != B.GetSingleFlag(Index))
+			return false;
+	}
+
+	return true;
+}
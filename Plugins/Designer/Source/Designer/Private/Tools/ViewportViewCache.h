@@ -0,0 +1,93 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UnrealClient.h"
+
+class FEditorViewportClient;
+struct FEngineShowFlags;
+class FSceneInterface;
+class FSceneView;
+class FSceneViewFamilyContext;
+
+/**
+ * Keeps the scene view of every viewport the cursor is traced in, so no view family has to be allocated for every mouse event.
+ * A view is only calculated again when the camera, the viewport, the show flags or the scene changes.
+ */
+class FViewportViewCache
+{
+private:
+	struct FCachedView
+	{
+		FVector ViewLocation = FVector::ZeroVector;
+
+		FRotator ViewRotation = FRotator::ZeroRotator;
+
+		float ViewFOV = 0.F;
+
+		float OrthoZoom = 0.F;
+
+		FIntPoint ViewportSize = FIntPoint::ZeroValue;
+
+		/** The viewport the view was calculated for, the view family refers to it */
+		FViewport* Viewport = nullptr;
+
+		int32 ViewportType = INDEX_NONE;
+
+		FSceneInterface* Scene = nullptr;
+
+		/** Owns the view */
+		TSharedPtr<FSceneViewFamilyContext> ViewFamily;
+
+		FSceneView* View = nullptr;
+	};
+
+	TMap<FEditorViewportClient*, FCachedView> Views;
+
+	uint32 HitCount;
+
+	uint32 MissCount;
+
+public:
+	FViewportViewCache();
+
+	/** Returns the view of the viewport, calculated again only if the camera, the viewport, the show flags or the scene changed */
+	const FSceneView* GetView(FEditorViewportClient* ViewportClient);
+
+	/** Release all cached views, the counters are kept */
+	void Empty();
+
+	FORCEINLINE uint32 GetHitCount() const { return HitCount; }
+
+	FORCEINLINE uint32 GetMissCount() const { return MissCount; }
+
+private:
+	/** Release the views of viewport clients which were destroyed, their address might be reused by a new viewport client */
+	void RemoveClosedViewports();
+
+	/** The show flags are bitfields without a comparison operator, so they are compared flag by flag */
+	static bool AreShowFlagsEqual(const FEngineShowFlags& A, const FEngineShowFlags& B);
+};
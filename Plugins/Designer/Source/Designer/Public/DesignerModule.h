@@ -4,9 +4,12 @@
 
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
+#include "Stats/Stats.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogDesigner, All, All);
 
+DECLARE_STATS_GROUP(TEXT("Designer"), STATGROUP_Designer, STATCAT_Advanced);
+
 class FDesignerModule : public IModuleInterface
 {
 public:
@@ -0,0 +1,189 @@
+/**
+ * MIT License
+ * 
+ * Copyright(c) 2018 RoelBartstra
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files(the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions :
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "UObject/ObjectSaveContext.h"
+#include "DesignerSettings.h"
+#include "DesignerPalette.generated.h"
+
+class UActorFactory;
+class FPlaceableAssetIndex;
+
+/**
+ * Designer settings which are overridden for a single palette entry
+ */
+USTRUCT(BlueprintType)
+struct FDesignerSettingsOverride
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Category = "Override", EditAnywhere, meta = (InlineEditConditionToggle))
+	bool bOverrideAxisToAlignWithNormal;
+
+	/** Actor axis vector to align with the hit surface direction */
+	UPROPERTY(Category = "Override", EditAnywhere, meta = (EditCondition = "bOverrideAxisToAlignWithNormal"))
+	EAxisType AxisToAlignWithNormal;
+
+	UPROPERTY(Category = "Override", EditAnywhere, meta = (InlineEditConditionToggle))
+	bool bOverrideAxisToAlignWithCursor;
+
+	/** Actor axis vector to align with the cursor direction */
+	UPROPERTY(Category = "Override", EditAnywhere, meta = (EditCondition = "bOverrideAxisToAlignWithCursor"))
+	EAxisType AxisToAlignWithCursor;
+
+	UPROPERTY(Category = "Override", EditAnywhere, meta = (InlineEditConditionToggle))
+	bool bOverrideRelativeLocationOffset;
+
+	/** The spawn location offset in relative space */
+	UPROPERTY(Category = "Override", EditAnywhere, meta = (EditCondition = "bOverrideRelativeLocationOffset"))
+	FVector RelativeLocationOffset;
+
+	UPROPERTY(Category = "Override", EditAnywhere, meta = (InlineEditConditionToggle))
+	bool bOverrideWorldLocationOffset;
+
+	/** The spawn location offset in world space */
+	UPROPERTY(Category = "Override", EditAnywhere, meta = (EditCondition = "bOverrideWorldLocationOffset"))
+	FVector WorldLocationOffset;
+
+	UPROPERTY(Category = "Override", EditAnywhere, meta = (InlineEditConditionToggle))
+	bool bOverrideRandomRotation;
+
+	/** Random rotation offset applied on spawn, only used when the override is enabled */
+	UPROPERTY(Category = "Override", EditAnywhere, meta = (EditCondition = "bOverrideRandomRotation"))
+	FRandomMinMaxVector RandomRotation;
+
+	UPROPERTY(Category = "Override", EditAnywhere, meta = (InlineEditConditionToggle))
+	bool bOverrideMinimalScale;
+
+	/** The minimal scale which is applied to the mesh when spawning */
+	UPROPERTY(Category = "Override", EditAnywhere, meta = (EditCondition = "bOverrideMinimalScale", UIMin = "0.1", UIMax = "1.0", ClampMin = "0.01", ClampMax = "10000.0"))
+	float MinimalScale;
+
+	UPROPERTY(Category = "Override", EditAnywhere, meta = (InlineEditConditionToggle))
+	bool bOverrideRandomScale;
+
+	/** Random scale, only used when the override is enabled */
+	UPROPERTY(Category = "Override", EditAnywhere, meta = (EditCondition = "bOverrideRandomScale"))
+	FRandomMinMaxVector RandomScale;
+
+public:
+	FDesignerSettingsOverride();
+
+	/** Returns true if any setting is overridden */
+	bool HasOverrides() const;
+
+	/** Apply the overridden settings on top of the settings */
+	void ApplyTo(UDesignerSettings* DesignerSettings) const;
+};
+
+/**
+ * A single asset in a designer palette
+ */
+USTRUCT(BlueprintType)
+struct FDesignerPaletteEntry
+{
+	GENERATED_BODY()
+
+	/** The asset to spawn, like a static mesh or a blueprint */
+	UPROPERTY(Category = "Entry", EditAnywhere)
+	TSoftObjectPtr<UObject> Asset;
+
+	/** The relative chance this entry is picked compared to the other entries */
+	UPROPERTY(Category = "Entry", EditAnywhere, meta = (ClampMin = "0.0", UIMax = "10.0"))
+	float Weight;
+
+	/** The designer settings overridden when spawning this entry */
+	UPROPERTY(Category = "Entry", EditAnywhere)
+	FDesignerSettingsOverride SettingsOverride;
+
+	/** True if the asset can be placed in the world, baked when the palette is saved */
+	UPROPERTY(Category = "Baked", VisibleAnywhere)
+	bool bPlaceable;
+
+	/** The local box extent of the spawned actor in cm when scale is uniform 1, baked when the palette is saved */
+	UPROPERTY(Category = "Baked", VisibleAnywhere)
+	FVector LocalExtent;
+
+	/** The class of the actor factory used to spawn the asset, baked when the palette is saved */
+	UPROPERTY(Category = "Baked", VisibleAnywhere)
+	TSubclassOf<UActorFactory> ActorFactoryClass;
+
+public:
+	FDesignerPaletteEntry();
+};
+
+/**
+ * A weighted set of assets the designer mode picks from instead of the assets selected in the content browser.
+ * Bounds, actor factories and placeability are baked when the palette is saved, so no work is left when spawning.
+ */
+UCLASS(BlueprintType)
+class DESIGNER_API UDesignerPalette : public UDataAsset
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+	/** The assets in this palette */
+	UPROPERTY(Category = "Palette", EditAnywhere)
+	TArray<FDesignerPaletteEntry> Entries;
+
+private:
+	/** The chance to keep the uniformly picked entry instead of its alias, see Vose's alias method */
+	UPROPERTY()
+	TArray<float> AliasProbabilities;
+
+	/** The entry picked when the uniformly picked entry is not kept */
+	UPROPERTY()
+	TArray<int32> AliasIndices;
+
+	/** The actor factories resolved from the baked factory classes, per entry */
+	UPROPERTY(Transient)
+	TArray<UActorFactory*> ResolvedActorFactories;
+
+public:
+	/** Pick a random placeable entry by weight in constant time. Returns INDEX_NONE when there is no placeable entry. */
+	int32 PickRandomEntryIndex() const;
+
+	/** The actor factory used to spawn the entry, resolved once from the baked factory class */
+	UActorFactory* GetActorFactory(int32 EntryIndex);
+
+	/** Bake the placeability, extent and actor factory of every entry and rebuild the alias table */
+	void Bake();
+
+	// UObject interface
+	virtual void PreSave(FObjectPreSaveContext ObjectSaveContext) override;
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+	/** Bake the placeability, extent and actor factory of a single entry, loading its asset */
+	static void BakeEntry(FDesignerPaletteEntry& Entry, FPlaceableAssetIndex& PlaceableAssetIndex);
+
+	/** Rebuild the alias table from the entry weights, entries which can't be placed are never picked */
+	void BuildAliasTable();
+};
@@ -26,9 +26,13 @@
 
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
+#include "Engine/EngineTypes.h"
 #include "DesignerSettings.generated.h"
 
 class FDesignerEdMode;
+class UDesignerPalette;
+class UPrimitiveComponent;
+class UStaticMesh;
 
 UENUM()
 enum class EAxisType : uint8
@@ -198,6 +202,58 @@ public:
 	}
 };
 
+/**
+ * How preview primitives are rendered.
+ * Previews move every frame, so anything which caches lighting or shadows for them is invalidated constantly.
+ */
+USTRUCT(BlueprintType)
+struct FPreviewRenderPolicy
+{
+	GENERATED_BODY()
+
+	/** Should previews cast shadows, moving shadow casters invalidate the cached shadow pages */
+	UPROPERTY(Category = "PreviewRendering", EditAnywhere)
+	bool bCastShadows;
+
+	/** Should previews affect distance field lighting, moving previews update the global distance field */
+	UPROPERTY(Category = "PreviewRendering", EditAnywhere)
+	bool bAffectDistanceFieldLighting;
+
+	/** Should previews affect dynamic indirect lighting */
+	UPROPERTY(Category = "PreviewRendering", EditAnywhere)
+	bool bAffectDynamicIndirectLighting;
+
+	/** Should previews be visible in ray tracing effects */
+	UPROPERTY(Category = "PreviewRendering", EditAnywhere)
+	bool bVisibleInRayTracing;
+
+	/** The LOD previews are forced to, 0 is automatic, 1 is LOD0, 2 is LOD1 and so on. Clamped to the LODs of the mesh. */
+	UPROPERTY(Category = "PreviewRendering", EditAnywhere, meta = (ClampMin = "0", UIMax = "8"))
+	int32 ForcedLOD;
+
+	/** The maximum triangle count of a previewed static mesh, the first LOD within the budget is used. 0 is unlimited. */
+	UPROPERTY(Category = "PreviewRendering", EditAnywhere, meta = (ClampMin = "0"))
+	int32 MaxTriangles;
+
+public:
+	FPreviewRenderPolicy()
+	{
+		this->bCastShadows = false;
+		this->bAffectDistanceFieldLighting = false;
+		this->bAffectDynamicIndirectLighting = false;
+		this->bVisibleInRayTracing = false;
+		this->ForcedLOD = 0;
+		this->MaxTriangles = 0;
+	}
+
+	/** Apply the policy to a preview primitive, the render state is recreated once if the component is registered */
+	void ApplyTo(UPrimitiveComponent* PrimitiveComponent) const;
+
+private:
+	/** The forced LOD model of the static mesh within the triangle budget, 0 is automatic */
+	int32 GetStaticMeshForcedLodModel(const UStaticMesh* StaticMesh) const;
+};
+
 /**
  * The settings shown the in editor mode details panel
  */
@@ -215,6 +271,18 @@ public:
 	UPROPERTY(Category = "AxisAlignment", EditAnywhere)
 	EAxisType AxisToAlignWithCursor;
 
+	/** Fit a plane to samples of the surface around the cursor and align with its normal, instead of the normal of the single hit under the cursor */
+	UPROPERTY(Category = "AxisAlignment", EditAnywhere)
+	bool bEstimateSurfaceNormal;
+
+	/** The distance from the cursor at which the surface is sampled */
+	UPROPERTY(Category = "AxisAlignment", EditAnywhere, meta = (EditCondition = "bEstimateSurfaceNormal", ClampMin = "1", UIMax = "500"))
+	float SurfaceNormalSampleRadius;
+
+	/** The number of samples in the circle around the cursor */
+	UPROPERTY(Category = "AxisAlignment", EditAnywhere, meta = (EditCondition = "bEstimateSurfaceNormal", ClampMin = "3", ClampMax = "32"))
+	int32 SurfaceNormalSampleCount;
+
 	/** The spawn location offset in relative space */
 	UPROPERTY(Category = "LocationSettings", EditAnywhere)
 	FVector RelativeLocationOffset;
@@ -267,6 +335,91 @@ public:
 	UPROPERTY(Category = "ScaleSettings", EditAnywhere, meta = (EditCondition = "bApplyRandomScale"))
 	FRandomMinMaxVector RandomScale;
 
+	/** When set, assets are picked from this palette instead of from the assets selected in the content browser */
+	UPROPERTY(Category = "Palette", EditAnywhere)
+	UDesignerPalette* Palette;
+
+	/** The number of recently placed assets which are kept loaded, so they don't have to be loaded again when they are picked again */
+	UPROPERTY(Category = "PerformanceSettings", EditAnywhere, meta = (ClampMin = "0", UIMax = "256"))
+	int32 ResidencyCacheMaxAssets;
+
+	/** The memory budget in megabytes for the recently placed assets kept loaded. The least recently placed assets are released first when exceeded. */
+	UPROPERTY(Category = "PerformanceSettings", EditAnywhere, meta = (ClampMin = "0", UIMax = "4096"))
+	int32 ResidencyCacheBudgetMB;
+
+	/**
+	 * Calculate the bounds of the selected assets in the background while the tool is active and store them on disk, so the bounds are known before an asset is loaded.
+	 * Every asset is loaded to do so, no more than the residency cache max assets are queued per selection.
+	 */
+	UPROPERTY(Category = "PerformanceSettings", EditAnywhere)
+	bool bPrefetchAssetExtents;
+
+	/** The number of hidden preview actors which are kept to be shown again instead of spawning new preview actors */
+	UPROPERTY(Category = "PerformanceSettings", EditAnywhere, meta = (ClampMin = "0", UIMax = "64"))
+	int32 PreviewPoolMaxActors;
+
+	/** The number of hidden preview actors which are kept per asset */
+	UPROPERTY(Category = "PerformanceSettings", EditAnywhere, meta = (ClampMin = "0", UIMax = "8"))
+	int32 PreviewPoolMaxActorsPerAsset;
+
+	/** Preview static meshes with a single component instead of spawning a preview actor */
+	UPROPERTY(Category = "PerformanceSettings", EditAnywhere)
+	bool bUseMeshPreviewComponent;
+
+	/** Preview blueprints with their mesh component templates instead of spawning a preview actor, so the construction script only runs when the actor is placed */
+	UPROPERTY(Category = "PerformanceSettings", EditAnywhere)
+	bool bUseBlueprintTemplatePreview;
+
+	/** The distance in world units the cursor ray may move away from the last traced hit location before the world is traced again */
+	UPROPERTY(Category = "PerformanceSettings", EditAnywhere, meta = (ClampMin = "0", UIMax = "16"))
+	float PlacementTraceCacheTolerance;
+
+	/** Trace the cursor with a single trace which stops at the first visible hit, instead of gathering and filtering all hits along the cursor ray */
+	UPROPERTY(Category = "PerformanceSettings", EditAnywhere)
+	bool bUseDesignerPlacementTrace;
+
+	/** The channel the cursor is traced against */
+	UPROPERTY(Category = "PerformanceSettings", EditAnywhere, meta = (EditCondition = "bUseDesignerPlacementTrace"))
+	TEnumAsByte<ECollisionChannel> PlacementTraceChannel;
+
+	/** When set, the cursor is traced against these object types instead of the trace channel */
+	UPROPERTY(Category = "PerformanceSettings", EditAnywhere, meta = (EditCondition = "bUseDesignerPlacementTrace"))
+	TArray<TEnumAsByte<EObjectTypeQuery>> PlacementTraceObjectTypes;
+
+	/** The collision profile of the preview actors. It should not respond to the placement trace, so the previews are never hit by it. */
+	UPROPERTY(Category = "PerformanceSettings", EditAnywhere)
+	FCollisionProfileName PreviewCollisionProfile;
+
+	/** Keep the triangles of the static meshes in the level in a hierarchy, so they can be traced in batches from worker threads without the physics scene */
+	UPROPERTY(Category = "PerformanceSettings", EditAnywhere)
+	bool bBuildStaticGeometryBVH;
+
+	/** When valid, the static meshes of every level overlapping this box are gathered instead of the static meshes of the current level */
+	UPROPERTY(Category = "PerformanceSettings", EditAnywhere, meta = (EditCondition = "bBuildStaticGeometryBVH"))
+	FBox StaticGeometryRegion;
+
+	/**
+	 * Place on landscapes by intersecting the cursor with their collision heights, without the physics scene.
+	 * The static geometry tells whether something is in front of the landscape, the placement trace is used when it can't.
+	 */
+	UPROPERTY(Category = "PerformanceSettings", EditAnywhere, meta = (EditCondition = "bBuildStaticGeometryBVH"))
+	bool bUseLandscapeHeightfieldPlacement;
+
+	/** Disable collision, navigation relevance and overlap events of the placed actor while it is dragged, and update them once when the mouse button is released */
+	UPROPERTY(Category = "PerformanceSettings", EditAnywhere)
+	bool bDeferControlledActorUpdates;
+
+	/**
+	 * Trace the cursor asynchronously while hovering and move the preview when the latest trace completed. Clicks always trace synchronously.
+	 * Requires the designer placement trace, the hits of the editor's placement trace can't be filtered the same way asynchronously.
+	 */
+	UPROPERTY(Category = "PerformanceSettings", EditAnywhere, meta = (EditCondition = "bUseDesignerPlacementTrace"))
+	bool bUseAsyncHoverTraces;
+
+	/** How preview actors and components are rendered */
+	UPROPERTY(Category = "PerformanceSettings", EditAnywhere)
+	FPreviewRenderPolicy PreviewRenderPolicy;
+
 public:
 	/**
 	 * Always returns the positive axis of the current selected AxisToAlignWithCursor
@@ -280,6 +433,9 @@ public:
 	/** Get the scale the spawned actor should have. Minimal scale is applied as well so it should never be lower than this value. */
 	FVector GetScale();
 
+	/** Copy all settings from the other settings object */
+	void CopySettingsFrom(const UDesignerSettings* Other);
+
 private:
 	FDesignerEdMode* ParentEdMode;
 